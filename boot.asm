@@ -5,6 +5,18 @@
 [org 0x7c00]
 [bits 16]
 
+; Load segment and entry point; the LZ4 image loads its decompression
+; stub at 0x70000 instead of the kernel itself at 0x10000
+%ifndef HOLOGRAPHIC_KERNEL_OFFSET
+%define HOLOGRAPHIC_KERNEL_OFFSET 0x1000
+%endif
+%ifndef KERNEL_ENTRY
+%define KERNEL_ENTRY 0x10000
+%endif
+; Boot-phase TSC stamps read by the kernel (BOOT_TSC_STAMP_ADDR):
+; +0 loader entry, +8 protected-mode switch
+BOOT_TSC_STAMPS equ 0x600
+
 start:
     cli
     xor ax, ax
@@ -16,6 +28,9 @@ start:
     sti
 
     mov [boot_drive], dl
+    rdtsc                      ; Clobbers EDX, so after saving DL
+    mov [BOOT_TSC_STAMPS], eax
+    mov [BOOT_TSC_STAMPS + 4], edx
 
     mov ax, 0x0003
     int 0x10
@@ -23,15 +38,34 @@ start:
     mov si, boot_msg
     call print
 
-    mov ax, HOLOGRAPHIC_KERNEL_OFFSET
-    mov es, ax
-    mov bx, 0x0000
-    mov dh, HOLOGRAPHIC_KERNEL_SECTORS
-    mov dl, [boot_drive]
     call disk_load
 
-    ; Load GDT and switch to protected mode
-    lgdt [gdt_descriptor]
+    ; Load GDT and switch to protected mode. No IDT exists until kmain
+    ; installs one, so keep IRQs off across the switch.
+    cli
+
+    ; The kernel's .bss starts at 8 MB and runs past 9 MB, so address
+    ; bit 20 must be live. Try fast A20 (port 0x92), then the keyboard
+    ; controller's output port; ES:0x7E0E is 0x107DFE, which aliases
+    ; 0x7DFE while A20 is gated.
+    push -1
+    pop es
+    in al, 0x92
+    or al, 0x02
+    and al, 0xFE               ; Bit 0 resets the machine
+    out 0x92, al
+    call a20_wraps
+    jne .a20_on
+    mov al, 0xD1               ; Write output port
+    out 0x64, al
+    call kbc_wait
+    mov al, 0xDF               ; A20 on, CPU out of reset
+    out 0x60, al
+    call kbc_wait              ; Falls through to the wrap test
+    mov si, a20_err_msg
+    je boot_fail
+.a20_on:
+    lgdt [gdt_start]
     mov eax, cr0
     or eax, 0x1
     mov cr0, eax
@@ -49,7 +83,11 @@ init_pm:
     mov ebp, 0x90000
     mov esp, ebp
 
-    jmp 0x10000
+    rdtsc
+    mov [BOOT_TSC_STAMPS + 8], eax
+    mov [BOOT_TSC_STAMPS + 12], edx
+
+    jmp KERNEL_ENTRY
 
 [bits 16]
 print:
@@ -65,38 +103,163 @@ print:
     popa
     ret
 
+; Loads HOLOGRAPHIC_KERNEL_SECTORS sectors from LBA 1 to
+; HOLOGRAPHIC_KERNEL_OFFSET:0. Uses INT 13h extensions (AH=42h) in
+; LBA_CHUNK_SECTORS chunks when the BIOS has them, else one sector per
+; AH=02h call with LBA->CHS conversion, so track and head boundaries are
+; crossed naturally. Each read is retried after a controller reset.
 disk_load:
-    pusha
-    mov ah, 0x02       ; BIOS read sector function
-    mov al, dh         ; Number of sectors to read
-    mov ch, 0x00       ; Cylinder number
-    mov dh, 0x00       ; Head number
-    mov cl, 0x02       ; Starting sector
+    mov ah, 0x41               ; Extensions present?
+    mov bx, 0x55AA
+    mov dl, [boot_drive]
+    int 0x13
+    jc .chs
+    cmp bx, 0xAA55
+    jne .chs
+    test cl, 1                 ; Packet (DAP) access supported?
+    jz .chs
 
-    int 0x13           ; Call BIOS disk services
-    jc disk_error      ; Jump if carry flag set (error)
+.lba_loop:
+    mov ax, [sectors_left]
+    test ax, ax
+    jz .done
+    cmp ax, LBA_CHUNK_SECTORS
+    jbe .lba_count
+    mov ax, LBA_CHUNK_SECTORS
+.lba_count:
+    mov [dap_count], ax
+    mov di, DISK_RETRIES
+.lba_retry:
+    mov si, dap
+    mov ah, 0x42
+    mov dl, [boot_drive]
+    int 0x13
+    jnc .lba_ok
+    call disk_reset
+    dec di
+    jnz .lba_retry
+    jmp .chs                   ; Extensions failing: finish with CHS
+.lba_ok:
+    mov ax, [dap_count]
+    call disk_advance
+    jmp .lba_loop
 
-    popa
+.chs:
+    push es                    ; AH=08h clobbers ES:DI
+    mov ah, 0x08               ; Drive geometry; keep the 1.44 MB default on error
+    mov dl, [boot_drive]
+    int 0x13
+    pop es
+    jc .chs_loop
+    and cl, 0x3F
+    mov [sectors_per_track], cl
+    inc dh
+    mov [head_count], dh
+.chs_loop:
+    cmp word [sectors_left], 0
+    je .done
+    mov ax, [dap_lba]
+    xor dx, dx
+    div word [sectors_per_track] ; AX = track, DX = sector - 1
+    inc dx
+    mov cl, dl
+    xor dx, dx
+    div word [head_count]      ; AX = cylinder, DX = head
+    mov ch, al
+    shl ah, 6                  ; Cylinder bits 8-9 go to CL bits 6-7
+    or cl, ah
+    mov dh, dl
+    mov di, DISK_RETRIES
+.chs_retry:
+    mov es, [dap_segment]
+    xor bx, bx
+    mov ax, 0x0201             ; Read one sector
+    mov dl, [boot_drive]
+    int 0x13
+    jnc .chs_ok
+    call disk_reset
+    dec di
+    jnz .chs_retry
+    jmp disk_error
+.chs_ok:
+    mov ax, 1
+    call disk_advance
+    jmp .chs_loop
+.done:
+    ret
+
+; AX = sectors just read
+disk_advance:
+    sub [sectors_left], ax
+    add [dap_lba], ax
+    shl ax, 5                  ; 512 bytes = 0x20 paragraphs
+    add [dap_segment], ax
+    ret
+
+disk_reset:
+    xor ax, ax
+    mov dl, [boot_drive]
+    int 0x13
     ret
 
 disk_error:
     mov si, disk_err_msg
+boot_fail:
     call print
     hlt
 
+; Waits for the keyboard controller's input buffer to drain, then runs
+; the wrap test below
+kbc_wait:
+    in al, 0x64
+    test al, 0x02
+    jnz kbc_wait
+; ZF set while 0x107DFE aliases 0x7DFE (A20 gated). ES = 0xFFFF. The
+; boot signature is no longer needed, so the test bumps it.
+a20_wraps:
+    mov si, 0x7DFE
+    mov di, 0x7E0E
+    inc word [si]
+    cmpsw
+    ret
+
 boot_msg db "[BOOT] Loading Holographic Kernel...", 0x0D, 0x0A, 0
 disk_err_msg db "[ERR] Disk read failed!", 0x0D, 0x0A, 0
+a20_err_msg db "[ERR] A20 failed!", 0
 boot_drive db 0
 
-HOLOGRAPHIC_KERNEL_OFFSET equ 0x1000
+LBA_CHUNK_SECTORS equ 64           ; 32 KB: chunks never straddle a 64 KB boundary
+DISK_RETRIES equ 3
 
+; The Makefile passes the real size: -DHOLOGRAPHIC_KERNEL_SECTORS=<n>
 %ifndef HOLOGRAPHIC_KERNEL_SECTORS
-HOLOGRAPHIC_KERNEL_SECTORS equ 20
+%define HOLOGRAPHIC_KERNEL_SECTORS 20
 %endif
+; Everything must sit below 0x80000: above it are the protected-mode
+; stack and the EBDA. 896 sectors from 0x10000.
+%define KERNEL_MAX_SECTORS ((0x8000 - HOLOGRAPHIC_KERNEL_OFFSET) / 0x20)
+%if HOLOGRAPHIC_KERNEL_SECTORS > KERNEL_MAX_SECTORS
+%error "the kernel image does not fit below 0x80000"
+%endif
+
+sectors_left dw HOLOGRAPHIC_KERNEL_SECTORS
+sectors_per_track dw 18        ; Words so that DIV can take them directly
+head_count dw 2
 
+; The DAP doubles as the load cursor: dap_segment and the low word of
+; dap_lba are where the next sector goes and where it comes from
+dap:
+    db 0x10, 0
+dap_count dw 0
+dap_offset dw 0
+dap_segment dw HOLOGRAPHIC_KERNEL_OFFSET
+dap_lba dd 1, 0
+
+; The null descriptor is never read, so LGDT's operand lives in it
 gdt_start:
-    dd 0x0
-    dd 0x0
+    dw gdt_end - gdt_start - 1
+    dd gdt_start
+    dw 0
 
 gdt_code:
     dw 0xffff
@@ -115,10 +278,6 @@ gdt_data:
     db 0x0
 gdt_end:
 
-gdt_descriptor:
-    dw gdt_end - gdt_start - 1
-    dd gdt_start
-
 CODE_SEG equ gdt_code - gdt_start
 DATA_SEG equ gdt_data - gdt_start
 
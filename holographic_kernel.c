@@ -1,15 +1,27 @@
 // kernel.c - Enhanced Holographic Kernel with Dynamic Manifolds, Genomes, and Emergent Behavior
-// IRQ AND UART DISABLED ON BOOT kmain
-// To stop crashing memory conflicts.
+// Interrupts stay disabled on boot until kmain has installed the IDT and
+// remapped the PIC; only IRQ0 (PIT) and IRQ4 (COM1 receive) are unmasked.
 // --- TYPE DEFINITIONS ---
 typedef unsigned char   uint8_t;
 typedef unsigned short  uint16_t;
 typedef unsigned int    uint32_t;
+typedef int             int32_t;
+typedef signed char     int8_t;
+typedef unsigned long long uint64_t;
+typedef long long       int64_t;
+#ifdef __x86_64__
+typedef unsigned long   size_t;
+#else
 typedef unsigned int    size_t;
+#endif
 typedef unsigned long   uintptr_t;
 #ifndef NULL
 #define NULL ((void *)0)
 #endif
+#include "include/telemetry.h"
+#include "include/corpus.h"
+#include "include/population.h"
+#include "include/symbols.h"
 // --- ENHANCED HOLOGRAPHIC MEMORY CONFIGURATION ---
 #define INITIAL_DIMENSIONS 512
 #define MAX_DIMENSIONS 2048
@@ -21,8 +33,211 @@ typedef unsigned long   uintptr_t;
 #define MAX_ENTITY_DOMAINS 8
 #define MAX_THOUGHTS 64
 #define MAX_GENES_PER_ENTITY 16
+// --- CONCEPT REGISTRY (lazy vocabulary) ---
+#define MAX_CONCEPTS 32768                // Names registered; vectors are built on first use
+#define CONCEPT_HASH_BUCKETS 65536        // Power of two, at most half full
+#define CONCEPT_NAME_POOL_SIZE 0x80000
+#define MAX_CONCEPT_ASSOCIATIONS 131072   // Corpus association edges, all concepts together
+#define CONCEPT_ASSOCIATION_WEIGHT 0.5f   // Share of each association in a concept's vector
+#define MAX_MATERIALIZED_CONCEPTS 256     // 2 KB of heap each
+#define VOCAB_SEED_THOUGHTS 16            // Concepts broadcast into the collective at boot
+#define CONCEPT_NONE 0xFFFF
+// --- KERNEL PATCH TRANSACTIONS ---
+#define PATCH_MAX_BYTES 16                // Largest single patch write
+#define PATCH_QUEUE_MAX 1024              // Pending patches, highest priority applied first
+#define PATCH_INDEX_SIZE 2048             // Power of two, at least twice PATCH_QUEUE_MAX
+#define PATCH_PRIORITY_OPERATOR 0xFFFFFFFF // Shell requests go ahead of every entity
+#define PATCH_ROLLBACK_ENTRIES 256        // Undo records kept, the oldest reused first
+#define PATCH_LIST_MAX 16                 // Rollback records shown by `patches`
+#define PATCH_HEALTH_ACTIVE_WEIGHT 100    // patch_health(): an active entity counts as this much fitness
+#define PATCH_STATE_FREE 0
+#define PATCH_STATE_TRIAL 1               // Applied, regression check pending
+#define PATCH_STATE_KEPT 2
+#define PATCH_STATE_REVERTED 3
+#define PATCH_STATE_SUPERSEDED 4          // Target rewritten since, so it can no longer be undone
+#define PATCH_PROPOSER_OPERATOR 0xFFFFFFFF // Staged from the serial shell, not by an entity
+#define PATCH_TRIAL_PAIRS_MAX 32          // Longest trial, in original/patched cycle pairs
+#define PATCH_FAIL_HEALTH 0x01            // Trial verdicts: what got worse
+#define PATCH_FAIL_COHERENCE 0x02
+#define PATCH_FAIL_SLOWER 0x04
+// --- RULE DISPATCH TABLE ---
+#define DIM_CLASS_SMALL 0                 // Up to 128 dimensions
+#define DIM_CLASS_MEDIUM 1                // Up to 512
+#define DIM_CLASS_LARGE 2
+#define DIM_CLASS_COUNT 3
+#define DISPATCH_CA_RULE 0
+#define DISPATCH_RESONANCE 1
+#define DISPATCH_MUTATION 2
+#define DISPATCH_RULE_SLOTS 3             // Slots entities may propose swaps for
+#define DISPATCH_SIMILARITY 3             // Kernel slots: one per DIM_CLASS_*
+#define DISPATCH_MERGE 6
+#define DISPATCH_HASH 9
+#define DISPATCH_SLOT_COUNT 12
+#define DISPATCH_MAX_VARIANTS 4
+#define AUTOTUNE_REPETITIONS 8            // Fastest of this many timed calls counts
+// --- GENE RULES ---
+#define RULE_MAX_OPS 8
+#define RULE_OP_LOAD 0                    // acc = sensor[arg]
+#define RULE_OP_ADD 1                     // acc += sensor[arg]
+#define RULE_OP_SUB 2                     // acc -= sensor[arg]
+#define RULE_OP_ADDI 3                    // acc += imm
+#define RULE_OP_SCALE 4                   // acc = (acc * imm) >> 10
+#define RULE_OP_THRESH 5                  // acc = acc > imm
+#define RULE_OP_SKIP_LE 6                 // if acc <= imm, skip the next arg ops
+#define RULE_OP_RET 7                     // return acc
+#define RULE_OP_COUNT 8
+#define RULE_SENSOR_NEIGHBORS 0           // Active neighbours x1000
+#define RULE_SENSOR_ACTIVE 1              // is_active x1000
+#define RULE_SENSOR_COHERENCE 2           // global_coherence x1000
+#define RULE_SENSOR_MEMORY_MATCH 3        // State similarity to the newest memory x1000
+#define RULE_SENSOR_CONFIDENCE 4          // x1000
+#define RULE_SENSOR_FITNESS 5             // fitness_score, saturating at 1000
+#define RULE_SENSOR_AGE 6                 // age, saturating at 1000
+#define RULE_SENSOR_THOUGHTS 7            // Thought-space occupancy x1000
+#define RULE_SENSOR_COUNT 8
+#define RULE_DRIVE_LIMIT 1000             // Rule output is clamped to +-this
+#define RULE_DRIVE_THRESHOLD 500          // |drive| at which a rule overrides the CA rule
+#define RULE_EXEC_OFF 0
+#define RULE_EXEC_JIT 1
+#define RULE_EXEC_VM 2
+#define JIT_ARENA_SIZE 0x10000            // Generated code; flushed whole when full
+#define JIT_MAX_CODE 128                  // Bytes one rule can compile to
+#define JIT_CACHE_SIZE 1024               // Power of two, compiled rules by genome hash
+#define JIT_TWEAK_STEP 50                 // Threshold change an entity proposes
+// --- SYMBOLS AND PROFILER ---
+#define PROFILE_SAMPLES 4096              // Timer-interrupt IP samples kept, a ring
+#define PROFILE_BUCKETS 256               // Power of two, distinct functions counted by `profile`
+#define PROFILE_TOP 12                    // Functions `profile` lists
+// --- INTERRUPTS ---
+#define IDT_ENTRIES 48                 // 32 CPU exceptions + 16 remapped PIC IRQs
+#define IRQ_BASE_VECTOR 0x20
+#define KERNEL_CODE_SELECTOR 0x08      // gdt_code in boot.asm
+#define PIT_FREQUENCY_HZ 1000
+// --- MULTIBOOT ---
+#define MULTIBOOT_BOOTLOADER_MAGIC 0x2BADB002
+#define MULTIBOOT_INFO_MEMORY 0x001
+#define MULTIBOOT_INFO_CMDLINE 0x004
+#define MULTIBOOT_INFO_MEM_MAP 0x040
+#define MULTIBOOT_MEMORY_AVAILABLE 1
+#define BOOT_CMDLINE_MAX 256
+// --- BOOT TIMING ---
+#define BOOT_TSC_STAMP_ADDR 0x600      // boot.asm: loader entry, protected-mode switch
+#define PIT_INPUT_HZ 1193182
+#define TSC_CALIBRATION_MS 10
+#define BOOT_MARK_LOADER 0
+#define BOOT_MARK_PROTECTED_MODE 1
+#define BOOT_MARK_KMAIN 2
+#define BOOT_MARK_SERIAL 3
+#define BOOT_MARK_HOLO_MEMORY 4
+#define BOOT_MARK_COLLECTIVE 5
+#define BOOT_MARK_VOCABULARY 6
+#define BOOT_MARK_DATA_DISK 7
+#define BOOT_MARK_CORPUS 8
+#define BOOT_MARK_CHECKPOINT 9
+#define BOOT_MARK_SEED 10
+#define BOOT_MARK_ENTITIES 11
+#define BOOT_MARK_INTERRUPTS 12
+#define BOOT_MARK_AUTOTUNE 13
+#define BOOT_MARK_MAIN_LOOP 14
+#define BOOT_MARK_COUNT 15
+// --- SERIAL COMMAND CHANNEL ---
+#define SERIAL_RX_RING_SIZE 256        // Power of two
+#define SERIAL_COMMAND_MAX 80
+// --- LOG LEVELS ---
+#define LOG_ERROR 0
+#define LOG_WARN 1
+#define LOG_INFO 2
+#define LOG_DEBUG 3
+// --- LOG SINKS (bit mask, a subsystem may route to several) ---
+#define LOG_SINK_COM1 0x01
+#define LOG_SINK_DEBUGCON 0x02         // QEMU -debugcon on port 0xE9, no status polling
+#define LOG_SINK_TRACE 0x04            // In-memory trace ring, dumped by the `trace` command
+#define LOG_SINK_VGA 0x08
+#define DEBUGCON_PORT 0xE9
+#ifndef LOG_DEFAULT_SINKS
+#define LOG_DEFAULT_SINKS LOG_SINK_COM1  // e.g. -DLOG_DEFAULT_SINKS=LOG_SINK_DEBUGCON for QEMU debug builds
+#endif
+#define TRACE_RING_SIZE 8192
+// --- LOG SUBSYSTEMS ---
+#define LOG_SUB_BOOT 0
+#define LOG_SUB_MEMORY 1
+#define LOG_SUB_GENOME 2
+#define LOG_SUB_COLLECTIVE 3
+#define LOG_SUB_ENTITY 4
+#define LOG_SUB_PATCH 5
+#define LOG_SUB_RENDER 6
+#define LOG_SUB_IRQ 7
+#define LOG_SUB_TELEMETRY 8            // Binary frames, see include/telemetry.h
+#define LOG_SUB_STORAGE 9              // Data disk and checkpoints
+#define LOG_SUBSYSTEM_COUNT 10
+// --- TELEMETRY ---
+#define CYCLE_TIME_WINDOW 64           // update_entities() timings kept for percentiles
+// --- DATA DISK (raw image on the ATA primary master, see the Makefile) ---
+#define ATA_SECTOR_SIZE 512
+#define DATA_DISK_CHECKPOINT_LBA 0              // Two alternating checkpoint slots
+#define DATA_DISK_CHECKPOINT_SLOT_SECTORS 2048  // 1 MB per slot, header in the first sector
+#define CHECKPOINT_BUFFER_BASE 0x00400000       // Staging area for one slot, below the journal buffer
+#define CHECKPOINT_PAYLOAD_MAX ((DATA_DISK_CHECKPOINT_SLOT_SECTORS - 1) * ATA_SECTOR_SIZE)
+#define CHECKPOINT_MAGIC 0x50434B48             // "HKCP"
+#define CHECKPOINT_VERSION 2                 // 2: rule-slot variants follow the counters
+#define DATA_DISK_CORPUS_LBA 4096               // Concept corpus, include/corpus.h
+#define DATA_DISK_CORPUS_SECTORS 26624
+#define DATA_DISK_POPULATION_LBA 30720          // Population image, include/population.h
+#define DATA_DISK_POPULATION_SECTORS 2048       // 1 MB, staged through CHECKPOINT_BUFFER_BASE
+#define POPULATION_PAYLOAD_MAX (DATA_DISK_POPULATION_SECTORS * ATA_SECTOR_SIZE - sizeof(PopulationHeader))
+#define DATA_DISK_JOURNAL_LBA 32768             // Record/replay journal
+#define DATA_DISK_JOURNAL_SECTORS 2048          // 1 MB, header in the first sector
+#define JOURNAL_BUFFER_BASE 0x00600000          // Whole journal staged in RAM, above the checkpoint buffer
+#define JOURNAL_RECORDS_MAX ((DATA_DISK_JOURNAL_SECTORS - 1) * ATA_SECTOR_SIZE)
+// The staging buffers are fixed ranges between the image, which the linker
+// scripts keep below CHECKPOINT_BUFFER_BASE, and .bss at 8 MB
+#define KERNEL_BSS_BASE 0x00800000              // linker.ld, linker64.ld
+_Static_assert(CHECKPOINT_BUFFER_BASE + DATA_DISK_CHECKPOINT_SLOT_SECTORS * ATA_SECTOR_SIZE <= JOURNAL_BUFFER_BASE &&
+               CHECKPOINT_BUFFER_BASE + DATA_DISK_POPULATION_SECTORS * ATA_SECTOR_SIZE <= JOURNAL_BUFFER_BASE,
+               "checkpoint buffer overlaps the journal buffer");
+_Static_assert(JOURNAL_BUFFER_BASE + DATA_DISK_JOURNAL_SECTORS * ATA_SECTOR_SIZE <= KERNEL_BSS_BASE,
+               "journal buffer overlaps .bss");
+#define JOURNAL_MAGIC 0x4E4A4B48                // "HKJN"
+#define JOURNAL_VERSION 1
+#define JOURNAL_SYNC_INTERVAL 16                // Update cycles between state digests
+#define JOURNAL_MODE_OFF 0
+#define JOURNAL_MODE_RECORD 1
+#define JOURNAL_MODE_REPLAY 2
+#define CORPUS_CHUNK_SECTORS 64                 // Per read; two chunk buffers alternate
 // --- VIDEO MEMORY ---
+#define VGA_COLS 80
+#define VGA_ROWS 25
+#define VGA_TEXT_VRAM_CELLS 16384                       // 32 KB of text VRAM behind 0xB8000
+#ifdef HOLO_HOSTED
+// Hosted build (`make hosted`): the fixed physical buffers become arrays
+static uint8_t hosted_checkpoint_buffer[DATA_DISK_CHECKPOINT_SLOT_SECTORS * ATA_SECTOR_SIZE];
+static uint8_t hosted_journal_buffer[DATA_DISK_JOURNAL_SECTORS * ATA_SECTOR_SIZE];
+static uint16_t hosted_vga[VGA_TEXT_VRAM_CELLS];
+#undef CHECKPOINT_BUFFER_BASE
+#undef JOURNAL_BUFFER_BASE
+#define CHECKPOINT_BUFFER_BASE ((uintptr_t)hosted_checkpoint_buffer)
+#define JOURNAL_BUFFER_BASE ((uintptr_t)hosted_journal_buffer)
+#define VIDEO_MEMORY ((uintptr_t)hosted_vga)
+#else
 #define VIDEO_MEMORY 0xb8000
+#endif
+#define VGA_BUFFER_ROWS (VGA_TEXT_VRAM_CELLS / VGA_COLS) // 204 rows of scroll-back ring
+#define VGA_SCAN_LINES_PER_ROW 16                       // Mode 3: 9x16 cells, 400 scan lines
+#define VGA_CRTC_INDEX 0x3D4
+#define VGA_CRTC_DATA 0x3D5
+// --- VBE LINEAR FRAMEBUFFER (Bochs/QEMU dispi interface) ---
+#ifndef ENABLE_VBE_HEATMAP
+#define ENABLE_VBE_HEATMAP 0                // Build with -DENABLE_VBE_HEATMAP=1 for graphics (adds the 1.2 MB back buffer)
+#endif
+#define VBE_DISPI_IOPORT_INDEX 0x01CE
+#define VBE_DISPI_IOPORT_DATA 0x01CF
+#define VBE_DISPI_LFB_DEFAULT 0xE0000000    // Used when the PCI BAR cannot be read
+#define VBE_WIDTH 640
+#define VBE_HEIGHT 480
+#define VBE_TILE_SIZE 16
+#define VBE_TILES_X (VBE_WIDTH / VBE_TILE_SIZE)
+#define VBE_TILES_Y (VBE_HEIGHT / VBE_TILE_SIZE)
+#define VBE_HISTORY_SAMPLES 256
 // --- Structure definitions (must come before function prototypes) ---
 typedef struct {
     float* data;           // Dynamically allocated array
@@ -77,33 +292,375 @@ typedef struct {
     uint32_t timestamp;
     uint8_t valid;
 } MemoryEntry;
+// A byte diff: what to write where, and the hash of what it replaces. The
+// intent names the change by hash; HyperVectors describing it go to the
+// collective at proposal time when the names are known concepts.
 typedef struct {
-    HyperVector pattern;      // The "before" state (e.g., a function signature)
-    HyperVector replacement;  // The "after" state (e.g., a mutated function)
     uint32_t address;         // Memory address to patch
+    uint32_t expected_hash;   // hash_data() of the target bytes the patch was proposed against
+    uint32_t bytes_hash;      // hash_data() of bytes: with address, the deduplication key
+    uint32_t intent;          // Hash of the intent names (old and new behaviour)
+    uint32_t proposer;        // Entity id
+    uint8_t length;           // Bytes written at address, at most PATCH_MAX_BYTES
     uint8_t applied;          // Has this patch been applied?
+    uint8_t bytes[PATCH_MAX_BYTES]; // New contents of the target
 } KernelPatch;
+// One update cycle as the trials see it
+struct PatchSample {
+    uint32_t cycle_tsc;       // TSC cycles the update took, 0 = not measured
+    uint32_t health;          // patch_health() after it
+    uint32_t coherence;       // global_coherence x1000 after it
+};
+// Sums over the trial cycles that ran one variant of the target
+struct PatchArm {
+    uint64_t cycle_tsc;
+    uint32_t slowest;         // Longest single cycle, left out of the mean
+    uint32_t timed;           // Cycles with a measured time
+    int32_t health;           // Change in patch_health() over those cycles
+    int32_t coherence;        // Change in coherence x1000
+};
+// Undo record of one applied patch
+struct PatchRollback {
+    uint32_t address;
+    uint32_t intent;
+    uint8_t length;
+    uint8_t original[PATCH_MAX_BYTES];
+    uint8_t patched[PATCH_MAX_BYTES]; // Written back for the patched half of the trial
+    uint32_t original_hash;   // hash_data() of each variant, to detect rewrites by others
+    uint32_t patched_hash;
+    uint32_t proposer;
+    uint32_t applied_cycle;   // sim_stats.update_cycles at commit
+    struct PatchSample start; // The cycle before the commit
+    struct PatchArm arms[2];  // Trial cycles run with the original [0] and patched [1] bytes
+    uint8_t pairs;            // Trial length in original/patched cycle pairs
+    uint8_t live;             // 1 while the patched bytes are in place
+    uint8_t state;            // PATCH_STATE_*
+    uint8_t failed;           // PATCH_FAIL_* that reverted it
+};
+// Pending patches live in fixed slots. A binary max-heap of slot numbers
+// orders them by priority and an open-addressed index finds a slot by
+// (address, bytes_hash), so enqueueing, deduplicating and popping are O(log n).
+struct PatchEngine {
+    KernelPatch pending[PATCH_QUEUE_MAX];
+    uint32_t priority[PATCH_QUEUE_MAX];
+    uint16_t heap[PATCH_QUEUE_MAX];       // Slot numbers, heap[0] the highest priority
+    uint16_t heap_pos[PATCH_QUEUE_MAX];   // Inverse of heap[]
+    uint16_t index[PATCH_INDEX_SIZE];     // Slot + 1 by key, 0 = empty
+    uint16_t free_slots[PATCH_QUEUE_MAX];
+    uint32_t free_count;
+    uint32_t slots_used;                  // Slots ever handed out; the rest are free too
+    uint32_t queued;                      // Heap size
+    struct PatchRollback rollback[PATCH_ROLLBACK_ENTRIES];
+    uint32_t rollback_next;   // Slot the next commit records into
+    struct PatchSample last;  // The update cycle that finished most recently
+    uint32_t committed;
+    uint32_t stale;           // Target changed between proposal and commit
+    uint32_t dropped;         // Queue full, self-modification disabled or target retired
+    uint32_t merged;          // Proposals folded into an identical queued patch
+    uint32_t reverted;
+    uint32_t accepted;        // Trials that ended with nothing worse
+};
+// Rules and kernels that update_entities() reaches through the dispatch
+// table. Slots hold a generic pointer, cast back to the slot's type at the call.
+typedef void (*dispatch_fn)(void);
+typedef uint8_t (*ca_rule_fn)(uint8_t is_active, uint32_t neighbor_active);
+typedef int (*resonance_fn)(const struct Entity* entity, float similarity);
+typedef uint32_t (*mutation_fn)(float* data, uint32_t dims, float rate, uint32_t seed);
+typedef float (*similarity_fn)(const float* a, const float* b, uint32_t dims);
+typedef void (*merge_fn)(float* dest, const float* src, uint32_t dims);
+typedef uint32_t (*hash_fn)(const void* input, uint32_t size);
+struct DispatchVariant {
+    const char* name;
+    dispatch_fn fn;
+};
+struct DispatchSlot {
+    const char* name;
+    const struct DispatchVariant* variants;   // Variant 0 is the original rule
+    uint32_t variant_count;
+    uint32_t bench_dims;                      // Kernel slots: vector size the autotuner times
+};
+// A gene rule: an accumulator program over the entity's sensors, decoded
+// from its genome hash. Branches only go forward, so every rule halts
+// within length steps.
+struct RuleOp {
+    uint8_t op;                   // RULE_OP_*
+    uint8_t arg;                  // Sensor index, or ops skipped by RULE_OP_SKIP_LE
+    int32_t imm;
+};
+struct RuleProgram {
+    uint32_t length;
+    struct RuleOp ops[RULE_MAX_OPS];
+};
+typedef int32_t (*jit_rule_fn)(const int32_t* sensors);
+// Threaded form of a RuleOp: the handler is a label address in vm_run_batch()
+struct VmInsn {
+    const void* handler;
+    uint8_t arg;
+    int32_t imm;
+};
+struct VmState {
+    uint32_t batches;             // vm_run_batch() calls
+    uint32_t lanes;               // Entities evaluated
+    uint32_t dispatches;          // Instructions dispatched, once per batch
+    uint32_t rejected;            // Programs the verifier refused
+};
+struct JitCacheEntry {
+    uint32_t key;                 // Genome hash, 0 = empty
+    uint32_t offset;              // Code start in the arena
+    uint16_t length;
+    uint16_t tune_offset;         // imm32 of the first compare, from offset; 0 = none
+};
+struct JitState {
+    struct JitCacheEntry cache[JIT_CACHE_SIZE];
+    uint32_t used;                // Arena bytes handed out
+    uint32_t entries;             // Cached rules
+    uint32_t compiles;
+    uint32_t hits;
+    uint32_t flushes;
+};
+// Last autotuner run: TSC cycles per variant per kernel slot
+struct AutotuneState {
+    uint32_t runs;
+    uint32_t cycles[DISPATCH_SLOT_COUNT][DISPATCH_MAX_VARIANTS];
+};
+struct DispatchTable {
+    volatile dispatch_fn fn[DISPATCH_SLOT_COUNT];  // Swapped with one aligned store
+    uint32_t version;                              // Bumped on every swap
+};
 struct HardwareInfo {
     char cpu_vendor[13];
     uint32_t cpu_features;
     uint32_t memory_kb;
     int device_count;
 };
+// Multiboot v1 information block (only the fields this kernel reads)
+struct MultibootInfo {
+    uint32_t flags;
+    uint32_t mem_lower;           // KB below 1 MB
+    uint32_t mem_upper;           // KB above 1 MB
+    uint32_t boot_device;
+    uint32_t cmdline;             // Physical address of a NUL-terminated string
+    uint32_t mods_count;
+    uint32_t mods_addr;
+    uint32_t syms[4];
+    uint32_t mmap_length;
+    uint32_t mmap_addr;
+} __attribute__((packed));
+struct MultibootMmapEntry {
+    uint32_t size;                // Size of the rest of the entry
+    uint64_t base;
+    uint64_t length;
+    uint32_t type;
+} __attribute__((packed));
+struct Concept {
+    uint32_t name_hash;            // hash_data(name, length + 1), also the vector seed
+    uint32_t name_offset;          // Into ConceptRegistry.names
+    uint16_t vector;               // Into ConceptRegistry.vectors, CONCEPT_NONE until first use
+    uint16_t association_count;
+    uint32_t association_first;    // Into ConceptRegistry.associations
+};
+struct ConceptRegistry {
+    struct Concept entries[MAX_CONCEPTS];
+    uint32_t count;
+    uint16_t buckets[CONCEPT_HASH_BUCKETS];  // Entry index + 1, 0 = empty
+    char names[CONCEPT_NAME_POOL_SIZE];
+    uint32_t names_used;
+    uint16_t associations[MAX_CONCEPT_ASSOCIATIONS]; // Concept indices
+    uint32_t association_count;
+    uint32_t associations_dropped;
+    HyperVector vectors[MAX_MATERIALIZED_CONCEPTS];
+    uint32_t materialized;
+};
+// First sector of the journal region; records follow from the next sector
+struct JournalHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;
+    uint32_t records_length;       // Bytes of records
+    uint32_t record_count;
+    uint32_t start_timestamp;      // global_timestamp at main-loop entry
+    uint32_t start_digest;         // journal_state_digest() at main-loop entry
+    uint32_t params_digest;        // hash of RuntimeParams at main-loop entry
+    uint32_t records_crc32;
+    uint32_t header_crc32;
+} __attribute__((packed));
 struct HolographicSystem {
     MemoryEntry memory_pool[MAX_MEMORY_ENTRIES];
     uint32_t memory_count;
     uint32_t global_timestamp;
 };
+// Tunables that used to be compile-time constants, settable over COM1.
+// Thresholds are fixed point x1000, matching how they are logged.
+struct RuntimeParams {
+    uint32_t update_interval;      // Timer ticks between update_entities() calls (the loop halts per tick)
+    uint32_t resonance_threshold;  // Similarity to a thought needed to resonate
+    uint32_t patch_confidence;     // Confidence above which an entity may propose a patch
+    uint32_t patch_fitness;        // fitness_score above which an entity may propose a patch
+    uint32_t patch_mutation_rate;  // mutation_rate above which an entity may propose a patch
+    uint32_t mutation_rate;        // Default mutation_rate (0-1000) of founding entities
+    uint32_t spawn_mutation_rate;  // mutation_rate (0-1000) of spawned entities
+    uint32_t top_k;                // Entities listed by the `stats` command
+    uint32_t telemetry_interval;   // Update cycles between telemetry frames, 0 = off
+    uint32_t vbe_heatmap;          // Switch to the VBE heatmap on the next render
+    uint32_t checkpoint_interval;  // Update cycles between checkpoints to the data disk, 0 = off
+    uint32_t restore_checkpoint;   // Resume from the newest checkpoint at boot when one exists
+    uint32_t import_population;    // Seed a fresh boot from the data disk's population image
+    uint32_t self_modify;          // Commit queued kernel patches at cycle boundaries
+    uint32_t patch_rate;           // Queued patches committed per cycle boundary at most
+    uint32_t patch_trial_cycles;   // Update cycles before a committed patch is checked for regression
+    uint32_t patch_regression;     // Health or coherence drop (per mille) over the trial that reverts a patch
+    uint32_t patch_slowdown;       // Cycle time rise (per mille) over the trial that reverts a patch, 0 = ignore
+    uint32_t autotune;             // Time kernel variants at boot and install the fastest
+    uint32_t autotune_interval;    // Update cycles between autotuner re-runs, 0 = boot only
+    uint32_t gene_rules;           // Run genome-encoded rules: 0 = off, 1 = JIT, 2 = VM
+    uint32_t profile;              // Sample the interrupted IP on every timer tick
+};
+struct LogConfig {
+    uint32_t level;                          // Messages above this level are dropped
+    uint8_t routes[LOG_SUBSYSTEM_COUNT];     // LOG_SINK_* mask per subsystem
+};
+struct TraceRing {
+    char data[TRACE_RING_SIZE];
+    uint32_t head;                           // Next write position
+    uint32_t count;                          // Valid bytes, saturates at TRACE_RING_SIZE
+};
+// Interrupted instruction pointers, written by the timer IRQ
+struct ProfileRing {
+    uint32_t ip[PROFILE_SAMPLES];
+    uint32_t head;
+    uint32_t count;                          // Saturates at PROFILE_SAMPLES
+};
+// First sector of a checkpoint slot; the payload follows in the next sectors
+struct CheckpointHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;
+    uint32_t sequence;             // The newest valid slot wins on restore
+    uint32_t payload_length;
+    uint32_t payload_crc32;
+    uint32_t global_timestamp;
+    uint32_t entity_count;
+    uint32_t memory_count;
+    uint32_t thought_count;
+    uint32_t vector_count;         // Distinct HyperVector data blocks in the payload
+    uint32_t header_crc32;         // Over the fields above
+} __attribute__((packed));
+// Counters that are not derivable from the current state, for telemetry
+struct SimStats {
+    uint32_t update_cycles;
+    uint32_t spawns;
+    uint32_t resonances;
+    uint32_t telemetry_sequence;
+    uint32_t cycle_times[CYCLE_TIME_WINDOW];   // Ring of TSC deltas per update cycle
+    uint32_t cycle_time_head;
+    uint32_t cycle_time_count;
+};
+struct SerialRxRing {
+    volatile uint8_t data[SERIAL_RX_RING_SIZE];
+    volatile uint32_t head;        // Written by the IRQ handler only
+    volatile uint32_t tail;        // Written by the main loop only
+    volatile uint32_t overruns;
+};
+#ifdef __x86_64__
+struct IdtEntry {
+    uint16_t offset_low;
+    uint16_t selector;
+    uint8_t ist;
+    uint8_t type_attr;
+    uint16_t offset_mid;
+    uint32_t offset_high;
+    uint32_t reserved;
+} __attribute__((packed));
+struct IdtPointer {
+    uint16_t limit;
+    uint64_t base;
+} __attribute__((packed));
+// Stack layout built by isr_common in kernel_entry64.asm
+struct InterruptFrame {
+    uint64_t r15, r14, r13, r12, r11, r10, r9, r8;
+    uint64_t rbp, rdi, rsi, rdx, rcx, rbx, rax;
+    uint64_t vector;
+    uint64_t error_code;
+    uint64_t ip, cs, flags, sp, ss;                  // Pushed by the CPU
+};
+#else
+struct IdtEntry {
+    uint16_t offset_low;
+    uint16_t selector;
+    uint8_t zero;
+    uint8_t type_attr;
+    uint16_t offset_high;
+} __attribute__((packed));
+struct IdtPointer {
+    uint16_t limit;
+    uint32_t base;
+} __attribute__((packed));
+// Stack layout built by isr_common in kernel_entry.asm
+struct InterruptFrame {
+    uint32_t edi, esi, ebp, esp, ebx, edx, ecx, eax; // pusha
+    uint32_t vector;
+    uint32_t error_code;
+    uint32_t ip, cs, flags;                          // Pushed by the CPU
+};
+#endif
 // --- KERNEL HEAP MEMORY MANAGEMENT ---
-static uint8_t kernel_heap[0xC0000]; // 128KB heap — KEEP ORIGINAL SIZE FOR STABILITY
+#if defined(__x86_64__) && defined(HOLO_HOSTED)
+#define KERNEL_HEAP_SIZE 0x02000000 // 32MB, as in the 64-bit kernel
+static uint8_t kernel_heap[KERNEL_HEAP_SIZE];
+#elif defined(__x86_64__)
+// Long mode identity-maps the first 4 GB, so the 32 MB heap gets a fixed
+// region of its own at 16 MB; linker64.ld checks that .bss ends below it
+#define KERNEL_HEAP_BASE 0x01000000
+#define KERNEL_HEAP_SIZE 0x02000000 // 32MB
+static uint8_t* const kernel_heap = (uint8_t*)KERNEL_HEAP_BASE;
+#else
+#define KERNEL_HEAP_SIZE 0xC0000
+static uint8_t kernel_heap[KERNEL_HEAP_SIZE]; // 128KB heap — KEEP ORIGINAL SIZE FOR STABILITY
+#endif
 static uint32_t heap_offset = 0;
+static uint32_t heap_peak = 0;     // High-water mark of heap_offset
 
 // --- NEW FUNCTION: Get remaining free heap space ---
 static size_t heap_get_free_space(void) {
-    return sizeof(kernel_heap) - heap_offset;
+    return KERNEL_HEAP_SIZE - heap_offset;
 }
 
 // --- PORT I/O FUNCTIONS (static inline) ---
+#ifdef HOLO_HOSTED
+// The hosted build runs as a Linux process under tools/holo_host.c. Byte
+// writes go to the driver, which prints COM1 and saves debugcon. Reads see
+// absent hardware, except that the COM1 transmitter is always ready and PIT
+// channel 2 never fires. Privileged instructions become no-ops.
+void hosted_port_write(uint16_t port, uint8_t value);
+int hosted_continue(uint32_t update_cycles);
+void hosted_map_executable(void* start, uint32_t length);
+static inline void outb(uint16_t port, uint8_t value) {
+    hosted_port_write(port, value);
+}
+static inline uint8_t inb(uint16_t port) {
+    if (port == 0x3F8 + 5) return 0x20;     // Transmit holding register empty
+    return port == 0x61 ? 0x00 : 0xFF;
+}
+static inline void outw(uint16_t port, uint16_t value) {
+    (void)port;
+    (void)value;
+}
+static inline uint16_t inw(uint16_t port) {
+    (void)port;
+    return 0xFFFF;
+}
+static inline void outl(uint16_t port, uint32_t value) {
+    (void)port;
+    (void)value;
+}
+static inline uint32_t inl(uint16_t port) {
+    (void)port;
+    return 0xFFFFFFFF;
+}
+static inline void cpu_disable_interrupts(void) {}
+static inline void cpu_enable_interrupts(void) {}
+static inline void cpu_halt(void) {}
+#else
 static inline void outb(uint16_t port, uint8_t value) {
     __asm__ volatile ("outb %0, %1" : : "a"(value), "Nd"(port));
 }
@@ -112,6 +669,43 @@ static inline uint8_t inb(uint16_t port) {
     __asm__ volatile ("inb %1, %0" : "=a"(ret) : "Nd"(port));
     return ret;
 }
+static inline void outw(uint16_t port, uint16_t value) {
+    __asm__ volatile ("outw %0, %1" : : "a"(value), "Nd"(port));
+}
+static inline uint16_t inw(uint16_t port) {
+    uint16_t ret;
+    __asm__ volatile ("inw %1, %0" : "=a"(ret) : "Nd"(port));
+    return ret;
+}
+static inline void outl(uint16_t port, uint32_t value) {
+    __asm__ volatile ("outl %0, %1" : : "a"(value), "Nd"(port));
+}
+static inline uint32_t inl(uint16_t port) {
+    uint32_t ret;
+    __asm__ volatile ("inl %1, %0" : "=a"(ret) : "Nd"(port));
+    return ret;
+}
+static inline void cpu_disable_interrupts(void) {
+    __asm__ volatile ("cli");
+}
+static inline void cpu_enable_interrupts(void) {
+    __asm__ volatile ("sti");
+}
+static inline void cpu_halt(void) {
+    __asm__ volatile ("hlt");
+}
+#endif
+static inline uint64_t rdtsc(void) {
+    uint32_t lo, hi;
+    __asm__ volatile ("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+// CPUID is architecturally serializing: code bytes stored before it are
+// the ones fetched after it, which self-modifying code needs.
+static inline void serialize_execution(void) {
+    uint32_t eax = 0, ebx, ecx = 0, edx;
+    __asm__ volatile ("cpuid" : "+a"(eax), "=b"(ebx), "+c"(ecx), "=d"(edx) : : "memory");
+}
 
 // --- SERIAL PORT FUNCTIONS ---
 static void serial_write(char c) {
@@ -129,32 +723,107 @@ static void serial_print(const char* str) {
 // --- END FIXED SECTION ---
 
 // --- VGA TEXT MODE FUNCTIONS ---
+// The whole 32 KB of text VRAM is used as a ring of VGA_BUFFER_ROWS rows.
+// Scrolling moves the CRTC start address instead of copying the screen, and
+// the CRTC line-compare register wraps the display back to VRAM row 0 when
+// the visible window runs past the end of the ring.
+struct VgaConsole {
+    uint16_t live_row;     // Ring row shown at the top of the screen when not scrolled back
+    uint16_t cursor_row;   // Ring row the cursor is on (always inside the live window)
+    uint16_t cursor_col;
+    uint16_t scrollback;   // Rows the view is scrolled back from the live window
+};
+static struct VgaConsole vga_console = {0};
+
+static void vga_crtc_write(uint8_t index, uint8_t value) {
+    outb(VGA_CRTC_INDEX, index);
+    outb(VGA_CRTC_DATA, value);
+}
+
+static uint8_t vga_crtc_read(uint8_t index) {
+    outb(VGA_CRTC_INDEX, index);
+    return inb(VGA_CRTC_DATA);
+}
+
+static void vga_set_line_compare(uint16_t scan_line) {
+    // Line compare is 10 bits: low 8 in 0x18, bit 8 in overflow (0x07) bit 4,
+    // bit 9 in maximum scan line (0x09) bit 6.
+    vga_crtc_write(0x18, (uint8_t)(scan_line & 0xFF));
+    vga_crtc_write(0x07, (uint8_t)((vga_crtc_read(0x07) & ~0x10) | ((scan_line >> 4) & 0x10)));
+    vga_crtc_write(0x09, (uint8_t)((vga_crtc_read(0x09) & ~0x40) | ((scan_line >> 3) & 0x40)));
+}
+
+static void vga_show_row(uint16_t top_row) {
+    uint16_t start = (uint16_t)(top_row * VGA_COLS);
+    vga_crtc_write(0x0C, (uint8_t)(start >> 8));
+    vga_crtc_write(0x0D, (uint8_t)(start & 0xFF));
+    // If the window runs off the end of the ring, restart at VRAM row 0 on the
+    // scan line where the ring ends. 0x3FF never matches, i.e. no split.
+    uint16_t rows_to_end = (uint16_t)(VGA_BUFFER_ROWS - top_row);
+    if (rows_to_end < VGA_ROWS) {
+        vga_set_line_compare((uint16_t)(rows_to_end * VGA_SCAN_LINES_PER_ROW - 1));
+    } else {
+        vga_set_line_compare(0x3FF);
+    }
+}
+
+static void vga_update_cursor(void) {
+    uint16_t pos = (uint16_t)(vga_console.cursor_row * VGA_COLS + vga_console.cursor_col);
+    vga_crtc_write(0x0E, (uint8_t)(pos >> 8));
+    vga_crtc_write(0x0F, (uint8_t)(pos & 0xFF));
+}
+
+static void vga_console_init(void) {
+    vga_console.live_row = 0;
+    vga_console.cursor_row = 0;
+    vga_console.cursor_col = 0;
+    vga_console.scrollback = 0;
+    vga_show_row(0);
+    vga_update_cursor();
+}
+
+// Scroll the view back by `rows` from the live window (0 returns to live).
+// Output always snaps the view back to the live window.
+static void vga_console_scrollback(uint16_t rows) {
+    if (rows > VGA_BUFFER_ROWS - VGA_ROWS) {
+        rows = VGA_BUFFER_ROWS - VGA_ROWS;
+    }
+    vga_console.scrollback = rows;
+    vga_show_row((uint16_t)((vga_console.live_row + VGA_BUFFER_ROWS - rows) % VGA_BUFFER_ROWS));
+}
+
+static void vga_new_line(uint8_t color) {
+    volatile uint16_t* video = (volatile uint16_t*)VIDEO_MEMORY;
+    vga_console.cursor_col = 0;
+    vga_console.cursor_row = (uint16_t)((vga_console.cursor_row + 1) % VGA_BUFFER_ROWS);
+    uint16_t last_live = (uint16_t)((vga_console.live_row + VGA_ROWS - 1) % VGA_BUFFER_ROWS);
+    if (vga_console.cursor_row != (uint16_t)((last_live + 1) % VGA_BUFFER_ROWS)) {
+        return;
+    }
+    // Cursor left the live window: recycle the oldest ring row and move the
+    // CRTC start address down one row. Only the new row is touched.
+    volatile uint16_t* row = video + vga_console.cursor_row * VGA_COLS;
+    uint16_t blank = (uint16_t)(((uint16_t)color << 8) | ' ');
+    for (uint32_t i = 0; i < VGA_COLS; i++) {
+        row[i] = blank;
+    }
+    vga_console.live_row = (uint16_t)((vga_console.live_row + 1) % VGA_BUFFER_ROWS);
+    vga_console.scrollback = 0;
+    vga_show_row(vga_console.live_row);
+}
+
 static void print_char(char c, uint8_t color) {
-    volatile char* video = (volatile char*)VIDEO_MEMORY;
-    static uint16_t cursor_pos = 0;
-    uint16_t pos_offset;
+    volatile uint16_t* video = (volatile uint16_t*)VIDEO_MEMORY;
+    if (vga_console.scrollback) {
+        vga_console_scrollback(0);
+    }
     if (c == '\n') {
-        // Move to the beginning of the next line
-        cursor_pos = (cursor_pos / 80 + 1) * 80;
+        vga_new_line(color);
     } else {
-        pos_offset = cursor_pos * 2;
-        video[pos_offset] = c;
-        video[pos_offset + 1] = color;
-        cursor_pos++;
-    }
-    // Simple scroll: if we've reached the end of the screen buffer
-    if (cursor_pos >= 80 * 25) {
-        // Move lines 1-24 down to lines 0-23
-        for (size_t i = 0; i < 80 * 24; i++) {
-            video[i * 2] = video[(i + 80) * 2];
-            video[i * 2 + 1] = video[(i + 80) * 2 + 1];
+        video[vga_console.cursor_row * VGA_COLS + vga_console.cursor_col] = (uint16_t)(((uint16_t)color << 8) | (uint8_t)c);
+        if (++vga_console.cursor_col >= VGA_COLS) {
+            vga_new_line(color);
         }
-        // Clear the last line (line 24)
-        for (size_t i = 0; i < 80; i++) {
-            video[(80 * 24 + i) * 2] = ' ';
-            video[(80 * 24 + i) * 2 + 1] = color; // Use current color
-        }
-        cursor_pos = 80 * 24; // Position cursor at the start of the new blank line
     }
 }
 
@@ -162,13 +831,12 @@ static void print(const char* str) {
     while (*str) {
         print_char(*str++, 0x0F); // White text on black background
     }
+    vga_update_cursor(); // Once per string: each cursor update is four port writes
 }
 
-// --- FIXED: Define print_hex BEFORE kmalloc ---
-static void print_hex(uint32_t value) {
+static void format_hex(char hex_str[11], uint32_t value) {
     char hex_chars[] = "0123456789ABCDEF";
-    char hex_str[11]; // 0x + 8 chars + null terminator
-    hex_str[10] = '\0';
+    hex_str[10] = '\0'; // 0x + 8 chars + null terminator
     int i;
     // Fill the string from the end
     for (i = 9; i >= 2; i--) {
@@ -177,22 +845,105 @@ static void print_hex(uint32_t value) {
     }
     hex_str[0] = '0';
     hex_str[1] = 'x';
+}
+
+static void format_dec(char dec_str[11], uint32_t value) {
+    char digits[10];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    int i = 0;
+    while (n) {
+        dec_str[i++] = digits[--n];
+    }
+    dec_str[i] = '\0';
+}
+
+// --- FIXED: Define print_hex BEFORE kmalloc ---
+static void print_hex(uint32_t value) {
+    char hex_str[11];
+    format_hex(hex_str, value);
     print(hex_str);
 }
 // --- END FIXED SECTION ---
 
+// --- LOG SINKS ---
+// Every subsystem logs through klog(); log_config.routes decides which
+// transports see it. COM1 polls the 16550 per byte, while debugcon and the
+// trace ring cost one outb or one store, so high-volume debug output
+// belongs there.
+static struct LogConfig log_config = {
+    LOG_DEBUG,
+    { LOG_DEFAULT_SINKS, LOG_DEFAULT_SINKS, LOG_DEFAULT_SINKS, LOG_DEFAULT_SINKS,
+      LOG_DEFAULT_SINKS, LOG_DEFAULT_SINKS, LOG_DEFAULT_SINKS, LOG_DEFAULT_SINKS,
+      LOG_SINK_DEBUGCON,    // Telemetry is binary: keep it off the COM1 shell
+      LOG_DEFAULT_SINKS }
+};
+static struct TraceRing trace_ring = {{0}, 0, 0};
+static volatile struct ProfileRing profile_ring = {{0}, 0, 0};
+static const char* const log_subsystem_names[LOG_SUBSYSTEM_COUNT] = {
+    "boot", "memory", "genome", "collective", "entity", "patch", "render", "irq", "telemetry",
+    "storage"
+};
+
+static void log_emit_bytes(uint8_t sinks, const void* data, uint32_t length) {
+    const char* p = (const char*)data;
+    for (uint32_t i = 0; i < length; i++) {
+        if (sinks & LOG_SINK_COM1) serial_write(p[i]);
+        if (sinks & LOG_SINK_DEBUGCON) outb(DEBUGCON_PORT, (uint8_t)p[i]);
+        if (sinks & LOG_SINK_TRACE) {
+            trace_ring.data[trace_ring.head] = p[i];
+            trace_ring.head = (trace_ring.head + 1) % TRACE_RING_SIZE;
+            if (trace_ring.count < TRACE_RING_SIZE) trace_ring.count++;
+        }
+        if (sinks & LOG_SINK_VGA) print_char(p[i], 0x07);
+    }
+    if (sinks & LOG_SINK_VGA) vga_update_cursor();
+}
+
+static void log_emit(uint8_t sinks, const char* str) {
+    uint32_t length = 0;
+    while (str[length]) length++;
+    log_emit_bytes(sinks, str, length);
+}
+
+static void klog(uint8_t subsystem, uint32_t level, const char* str) {
+    if (level > log_config.level || subsystem >= LOG_SUBSYSTEM_COUNT) return;
+    log_emit(log_config.routes[subsystem], str);
+}
+
+static void klog_hex(uint8_t subsystem, uint32_t level, uint32_t value) {
+    char hex_str[11];
+    format_hex(hex_str, value);
+    klog(subsystem, level, hex_str);
+}
+
+static void klog_dec(uint8_t subsystem, uint32_t level, uint32_t value) {
+    char dec_str[11];
+    format_dec(dec_str, value);
+    klog(subsystem, level, dec_str);
+}
+
+static void klog_signed(uint8_t subsystem, uint32_t level, int32_t value) {
+    klog(subsystem, level, value < 0 ? "-" : "+");
+    klog_dec(subsystem, level, value < 0 ? 0U - (uint32_t)value : (uint32_t)value);
+}
+
 static void* kmalloc(size_t size) {
-    if (heap_offset + size >= sizeof(kernel_heap)) {
+    if (heap_offset + size >= KERNEL_HEAP_SIZE) {
         // --- CRITICAL: LOG THE FAILURE ---
-        serial_print("[CRITICAL] kmalloc FAILED! Requested: ");
-        print_hex(size);
-        serial_print(" bytes. Free space: ");
-        print_hex(heap_get_free_space());
-        serial_print(" bytes.\n");
+        klog(LOG_SUB_MEMORY, LOG_ERROR, "[CRITICAL] kmalloc FAILED! Requested: ");
+        klog_hex(LOG_SUB_MEMORY, LOG_ERROR, size);
+        klog(LOG_SUB_MEMORY, LOG_ERROR, " bytes. Free space: ");
+        klog_hex(LOG_SUB_MEMORY, LOG_ERROR, heap_get_free_space());
+        klog(LOG_SUB_MEMORY, LOG_ERROR, " bytes.\n");
         return NULL; // Out of memory
     }
     void* ptr = &kernel_heap[heap_offset];
     heap_offset += (size + 7) & ~7; // 8-byte align
+    if (heap_offset > heap_peak) heap_peak = heap_offset;
     return ptr;
 }
 
@@ -239,6 +990,142 @@ static void serial_init(void) {
     serial_write('\n');
 }
 
+static void serial_print_dec(uint32_t value) {
+    char dec_str[11];
+    format_dec(dec_str, value);
+    serial_print(dec_str);
+}
+
+static void serial_print_signed(int32_t value) {
+    serial_print(value < 0 ? "-" : "+");
+    serial_print_dec(value < 0 ? 0U - (uint32_t)value : (uint32_t)value);
+}
+
+static void serial_print_hex(uint32_t value) {
+    char hex_str[11];
+    format_hex(hex_str, value);
+    serial_print(hex_str);
+}
+
+// --- KERNEL SYMBOLS ---
+// The second link pass places the table from tools/symtab_gen in .ksymtab,
+// between these linker-script symbols. The first pass leaves it empty and
+// lookups then find nothing.
+#ifndef HOLO_HOSTED
+extern const uint8_t __ksymtab_start[];
+extern const uint8_t __ksymtab_end[];
+#endif
+
+static const SymbolTableHeader* symbol_table(void) {
+#ifdef HOLO_HOSTED
+    return NULL;                  // The host's own tools (perf, gdb) have the symbols
+#else
+    const SymbolTableHeader* header = (const SymbolTableHeader*)__ksymtab_start;
+    uint32_t available = (uint32_t)(__ksymtab_end - __ksymtab_start);
+    if (available < sizeof(*header) || header->magic != SYMBOLS_MAGIC ||
+        header->version != SYMBOLS_VERSION || header->header_size != sizeof(*header) ||
+        header->count > (available - sizeof(*header)) / sizeof(SymbolEntry) ||
+        header->strings_length > available - sizeof(*header) - header->count * sizeof(SymbolEntry)) {
+        return NULL;
+    }
+    return header;
+#endif
+}
+
+// The symbol containing address, by binary search for the last one at or
+// below it. NULL outside every symbol or without a table.
+static const SymbolEntry* symbol_find(uint32_t address) {
+    const SymbolTableHeader* header = symbol_table();
+    if (!header) return NULL;
+    const SymbolEntry* entries = (const SymbolEntry*)(header + 1);
+    uint32_t low = 0, high = header->count;     // Answer is below high
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if (entries[mid].address <= address) low = mid + 1;
+        else high = mid;
+    }
+    if (low == 0) return NULL;
+    const SymbolEntry* entry = &entries[low - 1];
+    if (entry->size && address - entry->address >= entry->size) return NULL;
+    if (entry->name_offset >= header->strings_length) return NULL;
+    return entry;
+}
+
+static const char* symbol_name(const SymbolEntry* entry) {
+    const SymbolTableHeader* header = symbol_table();
+    const char* strings = (const char*)((const SymbolEntry*)(header + 1) + header->count);
+    return strings + entry->name_offset;
+}
+
+// "name" or "name+0xOFFSET" for an address, or "" when no symbol covers
+// it. The result lives in a static buffer.
+static const char* symbol_format(uint32_t address) {
+    static char text[SYMBOLS_NAME_MAX + 12];
+    const SymbolEntry* entry = symbol_find(address);
+    text[0] = '\0';
+    if (!entry) return text;
+    const char* name = symbol_name(entry);
+    uint32_t n = 0;
+    while (name[n] && n < SYMBOLS_NAME_MAX - 1) {
+        text[n] = name[n];
+        n++;
+    }
+    text[n] = '\0';
+    if (address != entry->address) {
+        text[n++] = '+';
+        format_hex(text + n, address - entry->address);
+    }
+    return text;
+}
+
+// Prints " (name+0xOFFSET)" when a symbol covers address
+static void serial_print_symbol(uint32_t address) {
+    const char* text = symbol_format(address);
+    if (!text[0]) return;
+    serial_print(" (");
+    serial_print(text);
+    serial_print(")");
+}
+
+static void klog_symbol(uint8_t subsystem, uint32_t level, uint32_t address) {
+    const char* text = symbol_format(address);
+    if (!text[0]) return;
+    klog(subsystem, level, " (");
+    klog(subsystem, level, text);
+    klog(subsystem, level, ")");
+}
+
+// --- SERIAL RECEIVE (IRQ4) ---
+static struct SerialRxRing serial_rx = {{0}, 0, 0, 0};
+
+#ifndef HOLO_HOSTED
+static void serial_enable_rx_irq(void) {
+    outb(0x3F8 + 1, 0x01); // Interrupt on received data only
+    outb(0x3F8 + 4, 0x0B); // DTR, RTS, OUT2 (OUT2 gates the IRQ line)
+}
+#endif
+
+static void serial_rx_irq(void) {
+    // Drain the FIFO: one interrupt may cover up to 14 bytes
+    while (inb(0x3F8 + 5) & 0x01) {
+        uint8_t c = inb(0x3F8);
+        uint32_t next = (serial_rx.head + 1) & (SERIAL_RX_RING_SIZE - 1);
+        if (next == serial_rx.tail) {
+            serial_rx.overruns++;
+            continue;
+        }
+        serial_rx.data[serial_rx.head] = c;
+        serial_rx.head = next;
+    }
+}
+
+static int serial_rx_pop(uint8_t* c) {
+    if (serial_rx.tail == serial_rx.head) return 0;
+    *c = serial_rx.data[serial_rx.tail];
+    serial_rx.tail = (serial_rx.tail + 1) & (SERIAL_RX_RING_SIZE - 1);
+    return 1;
+}
+
 // --- Enhanced Math Functions ---
 static float sqrtf(float x) {
     if (x <= 0.0f) return 0.0f;
@@ -269,8 +1156,20 @@ static char *strncpy(char *dest, const char *src, size_t n) {
     return dest;
 }
 
+static int str_equal(const char* a, const char* b) {
+    while (*a && *a == *b) {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
 //---Function Prototypes---
-void kmain(void) __attribute__((noreturn));
+#ifdef HOLO_HOSTED
+void kmain(uint32_t multiboot_magic, uint32_t multiboot_info_addr);
+#else
+void kmain(uint32_t multiboot_magic, uint32_t multiboot_info_addr) __attribute__((noreturn));
+#endif
 static uint32_t hash_data(const void* input, uint32_t size);
 // HyperVector functions
 static HyperVector create_hyper_vector(const void* input, uint32_t size);
@@ -290,27 +1189,123 @@ static void broadcast_thought(HyperVector* thought);
 static float compute_coherence(HyperVector* thought);
 // Holographic memory functions
 static void encode_holographic_memory(HyperVector* input, HyperVector* output);
-static HyperVector* retrieve_holographic_memory(uint32_t hash);
 static void initialize_holographic_memory(void);
-static void load_initial_genome_vocabulary(void);
+static uint32_t register_concept(const char* name);
+static HyperVector* lookup_concept(const char* name);
+static void register_genome_vocabulary(void);
+static int corpus_load(void);
+static void seed_collective_with_vocabulary(void);
+static float compute_batch_coherence(void);
 // Entity management functions
 static void initialize_emergent_entities(void);
 static struct Entity* spawn_entity(void);
 static void update_entities(void);
 static void render_entities_to_vga(void);
+// VBE visualisation functions
+static int vbe_init(void);
+static void vbe_render_frame(void);
+// Interrupt functions
+void isr_dispatch(struct InterruptFrame* frame);
+static void interrupts_init(void);
+// Telemetry functions
+static void telemetry_record_cycle(uint32_t tsc_cycles);
+static void telemetry_emit(void);
+// Boot timing functions
+static void boot_mark(uint32_t milestone);
+static void boot_read_loader_stamps(uint32_t multiboot_magic);
+static void boot_timing_report(void);
+// Data disk and checkpoints
+static void ata_init(void);
+static int checkpoint_save(void);
+static int checkpoint_load(void);
+static int population_export(uint8_t sinks);
+static int population_import(void);
+static void journal_begin(void);
+static void journal_command(char* line);
+static void journal_replay_poll(void);
+static void journal_update_cycle(void);
+static int journal_replaying(void);
+static int journal_enabled(void);
+static void command_journal(char* cursor);
+static char* next_token(char** cursor);
+// Serial command channel functions
+static void apply_boot_cmdline(const char* cmdline);
+static void serial_command_poll(void);
+static void serial_command_execute(char* line);
 // Hardware probing functions
 static void probe_hardware(void);
+static void read_multiboot_info(uint32_t magic, uint32_t info_addr);
 // Memory access functions
 static void set_memory_value(uint32_t address, uint8_t value);
 static uint8_t get_memory_value(uint32_t address);
 // --- PHASE 4: Self-Modifying Kernel Functions ---
-static void apply_kernel_patch(KernelPatch* patch);
-static void propose_kernel_patch(struct Entity* entity, HyperVector* old_pattern, HyperVector* new_pattern, uint32_t address);
+static int apply_kernel_patch(KernelPatch* patch);
+static void propose_kernel_patch(struct Entity* entity, uint32_t address, const void* bytes, uint32_t length,
+                                 const char* intent_from, const char* intent_to);
+static int patch_set_live(struct PatchRollback* entry, uint8_t live);
+static void patch_restart_trials(void);
+static int patch_revert(struct PatchRollback* entry);
+static int patch_enqueue(uint32_t address, const void* bytes, uint32_t length, uint32_t proposer,
+                         uint32_t priority, uint32_t intent);
+static int dispatch_propose_swap(uint32_t slot, uint32_t variant, uint32_t proposer);
+static uint32_t dispatch_variant_index(uint32_t slot);
+static void dispatch_note_write(uint32_t address);
+static void command_dispatch(char* cursor);
+static uint32_t dim_class(uint32_t dims);
+static void autotune_run(void);
+static void command_autotune(void);
+static uint32_t genome_hash(const struct Entity* entity);
+static void rule_decode(uint32_t key, struct RuleProgram* program);
+static const struct JitCacheEntry* jit_lookup(uint32_t key);
+static int rule_verify(const struct RuleProgram* program);
+static void rules_evaluate_all(void);
+static void jit_propose_tweak(struct Entity* entity);
+static void patch_forget_range(uint32_t start, uint32_t end);
+static KernelPatch* patch_queue_remove(uint32_t pos);
+static uint64_t udiv64_32(uint64_t n, uint32_t d);
+static void command_jit(char* cursor);
+static void patch_cycle_boundary(void);
+static void command_patches(char* cursor);
 // Global variables (all static, with consistent initialization)
 static struct Entity entity_pool[MAX_ENTITIES];
 static uint32_t active_entity_count = 0;
 static struct HolographicSystem holo_system = {0};
 static struct CollectiveConsciousness collective = {0};
+static struct ConceptRegistry concepts = {0};
+static struct HardwareInfo hw_info = {{0}, 0, 0, 0};
+static struct RuntimeParams params = {
+    500,        // update_interval (0.5 s at PIT_FREQUENCY_HZ)
+    600,        // resonance_threshold (0.6)
+    800,        // patch_confidence (0.8)
+    50,         // patch_fitness
+    100,        // patch_mutation_rate
+    50,         // mutation_rate (5%)
+    100,        // spawn_mutation_rate (10%)
+    5,          // top_k
+    10,         // telemetry_interval
+    ENABLE_VBE_HEATMAP, // vbe_heatmap
+    0,          // checkpoint_interval
+    1,          // restore_checkpoint
+    1,          // import_population
+    1,          // self_modify
+    2,          // patch_rate
+    8,          // patch_trial_cycles
+    200,        // patch_regression (20%)
+    100,        // patch_slowdown (10%)
+    1,          // autotune
+    1000,       // autotune_interval
+    RULE_EXEC_JIT, // gene_rules
+    1           // profile
+};
+static struct SimStats sim_stats = {0};
+static struct PatchEngine patch_engine = {0};
+static struct DispatchTable dispatch;    // Initialised with the rule variants below
+static struct AutotuneState autotune = {0};
+static struct JitState jit = {{{0, 0, 0, 0}}, 0, 0, 0, 0, 0};
+static uint8_t jit_arena[JIT_ARENA_SIZE] __attribute__((aligned(16)));
+static struct VmState vm = {0, 0, 0, 0};
+static volatile uint32_t timer_ticks = 0;  // IRQ0 at PIT_FREQUENCY_HZ
+static uint64_t boot_tsc[BOOT_MARK_COUNT]; // 0 = milestone not reached
 // Update entity state storage (moved from stack to avoid overflow)
 static uint8_t next_active[MAX_ENTITIES];
 static HyperVector next_state[MAX_ENTITIES];
@@ -318,9 +1313,15 @@ static char next_domain[MAX_ENTITIES][32];
 static HyperVector next_task_vector[MAX_ENTITIES];
 static uint32_t next_path_id[MAX_ENTITIES];
 static float next_task_alignment[MAX_ENTITIES];
+static int32_t rule_drive[MAX_ENTITIES];
+static int32_t rule_sensor_file[MAX_ENTITIES][RULE_SENSOR_COUNT];
 
 //---Kernel starting point---
-void kmain(void) {
+// multiboot_magic/multiboot_info_addr are EAX/EBX at entry. boot.asm leaves
+// junk there, so the info block is trusted only when the magic matches.
+void kmain(uint32_t multiboot_magic, uint32_t multiboot_info_addr) {
+    boot_mark(BOOT_MARK_KMAIN);
+    boot_read_loader_stamps(multiboot_magic);
     volatile char* video = (volatile char*)VIDEO_MEMORY;
     video[0] = 'H';
     video[1] = 0x0F;
@@ -332,44 +1333,97 @@ void kmain(void) {
     video[7] = 0x0F;
     video[8] = 'R';
     video[9] = 0x0F;
+    vga_console_init();
     serial_init();
-    serial_print("DEBUG: Serial initialized, HyperKernel starting!\n");
-__asm__ volatile ("cli"); // Disable interrupts
-    serial_print("Hyperdimensional Kernel (Dynamic Manifolds + Genomes) Starting...\n");
+    boot_mark(BOOT_MARK_SERIAL);
+    klog(LOG_SUB_BOOT, LOG_INFO, "DEBUG: Serial initialized, HyperKernel starting!\n");
+    read_multiboot_info(multiboot_magic, multiboot_info_addr);
+    cpu_disable_interrupts();
+#ifdef HOLO_HOSTED
+    hosted_map_executable(jit_arena, JIT_ARENA_SIZE);
+#endif
+    klog(LOG_SUB_BOOT, LOG_INFO, "Hyperdimensional Kernel (Dynamic Manifolds + Genomes) Starting...\n");
     print("Hyperdimensional Kernel (Dynamic Manifolds + Genomes) Starting...\n");
     print("Initializing dynamic hyperdimensional memory system...\n");
     initialize_holographic_memory();
+    boot_mark(BOOT_MARK_HOLO_MEMORY);
     initialize_collective_consciousness();
-    load_initial_genome_vocabulary();
-    initialize_emergent_entities();
-    // Assign Initial Task Vectors with dynamic expansion
-    HyperVector path_vector = create_hyper_vector("network_io_path", strlen("network_io_path") + 1);
-    for (uint32_t i = 0; i < active_entity_count && i < 2; i++) {
-        entity_pool[i].task_vector = path_vector;
-        entity_pool[i].path_id = 0xA1;
-        entity_pool[i].mutation_rate = 100; // 10% mutation rate
-        serial_print("[TASK] Assigned dynamic path 0xA1 to entity ");
-        print_hex(entity_pool[i].id);
-        serial_print("\n");
+    boot_mark(BOOT_MARK_COLLECTIVE);
+    register_genome_vocabulary();
+    boot_mark(BOOT_MARK_VOCABULARY);
+    ata_init();
+    boot_mark(BOOT_MARK_DATA_DISK);
+    corpus_load();
+    boot_mark(BOOT_MARK_CORPUS);
+    int restored = params.restore_checkpoint && checkpoint_load() == 0;
+    boot_mark(BOOT_MARK_CHECKPOINT);
+    if (restored) {
+        print("Resumed population from data disk checkpoint.\n");
+    } else {
+        seed_collective_with_vocabulary();
+        boot_mark(BOOT_MARK_SEED);
+        if (params.import_population && population_import() == 0) {
+            print("Seeded population from data disk population image.\n");
+        } else {
+            initialize_emergent_entities();
+            // Assign Initial Task Vectors with dynamic expansion
+            HyperVector path_vector = create_hyper_vector("network_io_path", strlen("network_io_path") + 1);
+            for (uint32_t i = 0; i < active_entity_count && i < 2; i++) {
+                entity_pool[i].task_vector = path_vector;
+                entity_pool[i].path_id = 0xA1;
+                entity_pool[i].mutation_rate = 100; // 10% mutation rate
+                klog(LOG_SUB_BOOT, LOG_INFO, "[TASK] Assigned dynamic path 0xA1 to entity ");
+                klog_hex(LOG_SUB_BOOT, LOG_INFO, entity_pool[i].id);
+                klog(LOG_SUB_BOOT, LOG_INFO, "\n");
+            }
+        }
+        boot_mark(BOOT_MARK_ENTITIES);
     }
     print("Hyperdimensional Kernel with Dynamic Genomes Initialized!\n");
     print("System entering emergent entity loop with collective consciousness...\n");
-    serial_print("[BOOT] HyperKernel fully initialized. Evolution engine online.\n");
+    klog(LOG_SUB_BOOT, LOG_INFO, "[BOOT] HyperKernel fully initialized. Evolution engine online.\n");
+    interrupts_init();
+    boot_mark(BOOT_MARK_INTERRUPTS);
+    cpu_enable_interrupts(); // Safe now: every vector has a handler
+    if (params.autotune) autotune_run();
+    boot_mark(BOOT_MARK_AUTOTUNE);
     uint32_t last_update = 0;
-    uint32_t update_interval = 500000;
+    boot_mark(BOOT_MARK_MAIN_LOOP);
+    boot_timing_report();
+    journal_begin();
     while (1) {
-        if (holo_system.global_timestamp - last_update > update_interval) {
+        serial_command_poll();
+        journal_replay_poll();
+        if (holo_system.global_timestamp - last_update > params.update_interval) {
+            uint64_t cycle_start = rdtsc();
             update_entities();
+            telemetry_record_cycle((uint32_t)(rdtsc() - cycle_start));
+            patch_cycle_boundary();
             render_entities_to_vga();
+            if (params.telemetry_interval && sim_stats.update_cycles % params.telemetry_interval == 0) {
+                telemetry_emit();
+            }
+            if (params.checkpoint_interval && sim_stats.update_cycles % params.checkpoint_interval == 0) {
+                checkpoint_save();
+            }
+            if (params.autotune && params.autotune_interval &&
+                sim_stats.update_cycles % params.autotune_interval == 0) {
+                autotune_run();
+            }
+            journal_update_cycle();
             last_update = holo_system.global_timestamp;
+#ifdef HOLO_HOSTED
+            if (!hosted_continue(sim_stats.update_cycles)) return;
+#endif
         }
         holo_system.global_timestamp++;
-        __asm__ volatile("hlt");
+        // Replays run flat out: the loop count, not the clock, paces the simulation
+        if (!journal_replaying()) cpu_halt();
     }
 }
 
 //---Hash function (FNV-1a)---
-static uint32_t hash_data(const void* input, uint32_t size) {
+static uint32_t hash_fnv1a(const void* input, uint32_t size) {
     const uint8_t* data = (const uint8_t*)input;
     uint32_t hash = 2166136261U;
     for (uint32_t i = 0; i < size; i++) {
@@ -380,6 +1434,20 @@ static uint32_t hash_data(const void* input, uint32_t size) {
 }
 
 //---PHASE 1: Dynamic Hyperdimensional Manifold Functions---
+// Adds weight x the sparse pseudo-random pattern for seed (about one
+// dimension in ten) into data. Returns the number of dimensions it touched.
+static uint32_t add_seeded_pattern(float* data, uint32_t capacity, uint32_t seed, float weight) {
+    uint32_t touched = 0;
+    for (uint32_t i = 0; i < capacity; i++) {
+        seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+        if ((seed % 10) == 0) {
+            data[i] += weight * (((float)((seed % 2000) - 1000)) / 1000.0f);
+            touched++;
+        }
+    }
+    return touched;
+}
+
 static HyperVector create_hyper_vector(const void* input, uint32_t size) {
     HyperVector vec = {0};
     vec.capacity = INITIAL_DIMENSIONS;
@@ -388,21 +1456,13 @@ static HyperVector create_hyper_vector(const void* input, uint32_t size) {
     vec.valid = 1;
     // --- ADD THIS CHECK ---
     if (!vec.data) {
-        serial_print("[ERROR] create_hyper_vector: Out of memory!\n");
+        klog(LOG_SUB_MEMORY, LOG_ERROR, "[ERROR] create_hyper_vector: Out of memory!\n");
         vec.valid = 0;
         return vec;
     }
     // Initialize with zeros
     memset(vec.data, 0, vec.capacity * sizeof(float));
-    uint32_t seed = hash_data(input, size);
-    vec.hash_sig = seed;
-    for (uint32_t i = 0; i < vec.capacity; i++) {
-        seed = (seed * 1103515245 + 12345) & 0x7fffffff;
-        if ((seed % 10) == 0) {
-            vec.data[i] = ((float)((seed % 2000) - 1000)) / 1000.0f;
-            vec.active_dims++;
-        }
-    }
+    vec.active_dims = add_seeded_pattern(vec.data, vec.capacity, hash_data(input, size), 1.0f);
     // Re-hash active subspace
     vec.hash_sig = hash_data(vec.data, vec.active_dims * sizeof(float));
     return vec;
@@ -414,7 +1474,7 @@ static void grow_manifold(HyperVector* vec, uint32_t new_capacity) {
     }
     float* new_data = (float*)kmalloc(new_capacity * sizeof(float));
     if (!new_data) {
-        serial_print("[ERROR] Failed to grow manifold - out of memory\n");
+        klog(LOG_SUB_MEMORY, LOG_ERROR, "[ERROR] Failed to grow manifold - out of memory\n");
         return;
     }
     // Copy existing data
@@ -426,9 +1486,9 @@ static void grow_manifold(HyperVector* vec, uint32_t new_capacity) {
     vec->data = new_data;
     vec->capacity = new_capacity;
     vec->hash_sig = hash_data(vec->data, vec->active_dims * sizeof(float));
-    serial_print("[GROW] Manifold expanded to ");
-    print_hex(new_capacity);
-    serial_print(" dimensions\n");
+    klog(LOG_SUB_MEMORY, LOG_INFO, "[GROW] Manifold expanded to ");
+    klog_hex(LOG_SUB_MEMORY, LOG_INFO, new_capacity);
+    klog(LOG_SUB_MEMORY, LOG_INFO, " dimensions\n");
 }
 
 static void destroy_hyper_vector(HyperVector* vec) {
@@ -439,119 +1499,366 @@ static void destroy_hyper_vector(HyperVector* vec) {
     }
 }
 
-static float compute_similarity(HyperVector* a, HyperVector* b) {
-    if (!a || !b || !a->valid || !b->valid || !a->data || !b->data) {
-        return 0.0f;
-    }
-    uint32_t min_dims = (a->active_dims < b->active_dims) ? a->active_dims : b->active_dims;
-    if (min_dims == 0) return 0.0f;
-    float dot = 0.0f;
-    float mag_a = 0.0f, mag_b = 0.0f;
-    for (uint32_t i = 0; i < min_dims; i++) {
-        dot += a->data[i] * b->data[i];
-        mag_a += a->data[i] * a->data[i];
-        mag_b += b->data[i] * b->data[i];
-    }
-    mag_a = (mag_a > 0) ? sqrtf(mag_a) : 1.0f;
-    mag_b = (mag_b > 0) ? sqrtf(mag_b) : 1.0f;
-    return (mag_a * mag_b > 0) ? (dot / (mag_a * mag_b)) : 0.0f;
-}
-
 static void merge_hyper_vectors(HyperVector* dest, HyperVector* src) {
     if (!dest || !src || !dest->valid || !src->valid) return;
     uint32_t min_dims = (dest->active_dims < src->active_dims) ? dest->active_dims : src->active_dims;
-    for (uint32_t i = 0; i < min_dims; i++) {
-        dest->data[i] = (dest->data[i] + src->data[i]) * 0.5f; // Average merge
-    }
+    ((merge_fn)dispatch.fn[DISPATCH_MERGE + dim_class(min_dims)])(dest->data, src->data, min_dims);
     dest->hash_sig = hash_data(dest->data, dest->active_dims * sizeof(float));
 }
 
-//---PHASE 2: Self-Modifying Genome Functions---
-static struct Gene* create_gene(const char* name, HyperVector pattern) {
-    struct Gene* gene = (struct Gene*)kmalloc(sizeof(struct Gene));
-    // --- ADD THIS CHECK ---
-    if (!gene) {
-        serial_print("[ERROR] create_gene: Out of memory!\n");
-        return NULL;
-    }
-    gene->pattern = pattern;
-    gene->next = NULL;
-    gene->fitness = 0;
-    gene->mutable = 1;
-    strncpy(gene->name, name, 15);
-    gene->name[15] = '\0';
-    return gene;
+// --- RULE DISPATCH TABLE ---
+// Each slot starts on variant 0, the original rule. The similarity, merge
+// and hash kernels have one slot per vector size class, which the autotuner
+// fills with the fastest variant. Entities (rule slots only) and the
+// `dispatch` command propose swaps, which go through the patch engine as an
+// ordinary kernel patch of the slot's pointer: checked against the current
+// pointer, committed at a cycle boundary with one aligned store, and
+// reverted like any other patch if the system regresses.
+
+// Original rule: a dormant entity wakes when a neighbour is active and
+// sleeps again when none is.
+static uint8_t ca_rule_reactive(uint8_t is_active, uint32_t neighbor_active) {
+    (void)is_active;
+    return neighbor_active > 0;
 }
 
-static void mutate_gene(struct Gene* gene, float rate) {
-    if (!gene || !gene->mutable || !gene->pattern.valid) return;
+// Rule 90: active when exactly one neighbour is.
+static uint8_t ca_rule_parity(uint8_t is_active, uint32_t neighbor_active) {
+    (void)is_active;
+    return neighbor_active == 1;
+}
+
+// Wakes like the reactive rule but never sleeps.
+static uint8_t ca_rule_sustain(uint8_t is_active, uint32_t neighbor_active) {
+    return is_active || neighbor_active > 0;
+}
+
+static int resonance_threshold(const struct Entity* entity, float similarity) {
+    (void)entity;
+    return similarity * 1000.0f > (float)params.resonance_threshold;
+}
+
+// Confident entities resonate more easily: the threshold scales by 1.5 - confidence.
+static int resonance_confidence(const struct Entity* entity, float similarity) {
+    float scale = 1.5f - entity->confidence;
+    if (scale < 0.5f) scale = 0.5f;
+    return similarity * 1000.0f > (float)params.resonance_threshold * scale;
+}
+
+// Original kernel: a hash decides for every dimension whether it mutates.
+static uint32_t mutation_dense(float* data, uint32_t dims, float rate, uint32_t seed) {
     uint32_t mutations = 0;
-    for (uint32_t i = 0; i < gene->pattern.active_dims; i++) {
-        if (((holo_system.global_timestamp * 1103515245 + i) % 1000) < (uint32_t)(rate * 1000)) {
-            gene->pattern.data[i] += ((float)(((holo_system.global_timestamp + i) % 2000) - 1000)) / 10000.0f;
-            gene->fitness = 0; // Reset fitness after mutation
+    for (uint32_t i = 0; i < dims; i++) {
+        if (((seed * 1103515245 + i) % 1000) < (uint32_t)(rate * 1000)) {
+            data[i] += ((float)(((seed + i) % 2000) - 1000)) / 10000.0f;
             mutations++;
         }
     }
-    if (mutations > 0) {
-        gene->pattern.hash_sig = hash_data(gene->pattern.data, gene->pattern.active_dims * sizeof(float));
-        serial_print("[MUTATE] Gene ");
-        serial_print(gene->name);
-        serial_print(" mutated ");
-        print_hex(mutations);
-        serial_print(" dimensions\n");
+    return mutations;
+}
+
+// Draws rate * dims dimensions with an LCG instead of testing every one.
+static uint32_t mutation_sparse(float* data, uint32_t dims, float rate, uint32_t seed) {
+    uint32_t count = (uint32_t)(rate * (float)dims);
+    uint32_t state = seed;
+    if (dims == 0) return 0;
+    for (uint32_t n = 0; n < count; n++) {
+        state = state * 1103515245 + 12345;
+        uint32_t i = (state >> 8) % dims;
+        data[i] += ((float)(((seed + i) % 2000) - 1000)) / 10000.0f;
     }
+    return count;
 }
 
-static struct Gene* invent_gene(HyperVector pattern) {
-    struct Gene* new_gene = (struct Gene*)kmalloc(sizeof(struct Gene));
-    if (!new_gene) return NULL;
-    new_gene->pattern = pattern;
-    new_gene->next = NULL;
-    new_gene->fitness = 0;
-    new_gene->mutable = 1;
-    strncpy(new_gene->name, "invented", 15);
-    new_gene->name[15] = '\0';
-    return new_gene;
+// Original kernels. The others give the same result (similarity only to
+// rounding: the accumulation order differs) and are picked by the autotuner.
+static float similarity_cosine(const float* a, const float* b, uint32_t dims) {
+    float dot = 0.0f;
+    float mag_a = 0.0f, mag_b = 0.0f;
+    for (uint32_t i = 0; i < dims; i++) {
+        dot += a[i] * b[i];
+        mag_a += a[i] * a[i];
+        mag_b += b[i] * b[i];
+    }
+    mag_a = (mag_a > 0) ? sqrtf(mag_a) : 1.0f;
+    mag_b = (mag_b > 0) ? sqrtf(mag_b) : 1.0f;
+    return (mag_a * mag_b > 0) ? (dot / (mag_a * mag_b)) : 0.0f;
 }
 
-static void add_gene_to_entity(struct Entity* entity, struct Gene* gene) {
-    if (!entity || !gene || entity->gene_count >= MAX_GENES_PER_ENTITY) return;
-    // Add to front of linked list
-    gene->next = entity->genome;
-    entity->genome = gene;
-    entity->gene_count++;
-    serial_print("[GENOME] Added gene ");
-    serial_print(gene->name);
-    serial_print(" to entity ");
-    print_hex(entity->id);
-    serial_print("\n");
+static void merge_average(float* dest, const float* src, uint32_t dims) {
+    for (uint32_t i = 0; i < dims; i++) {
+        dest[i] = (dest[i] + src[i]) * 0.5f; // Average merge
+    }
 }
 
-static void destroy_genome(struct Gene* genome) {
-    struct Gene* current = genome;
-    while (current) {
-        struct Gene* next = current->next;
-        destroy_hyper_vector(&current->pattern);
-        kfree(current);
-        current = next;
+// Four independent accumulator sets, so the adds pipeline.
+static float similarity_cosine_unrolled(const float* a, const float* b, uint32_t dims) {
+    float dot[4] = {0}, mag_a[4] = {0}, mag_b[4] = {0};
+    uint32_t i = 0;
+    for (; i + 4 <= dims; i += 4) {
+        for (uint32_t k = 0; k < 4; k++) {
+            dot[k] += a[i + k] * b[i + k];
+            mag_a[k] += a[i + k] * a[i + k];
+            mag_b[k] += b[i + k] * b[i + k];
+        }
+    }
+    for (; i < dims; i++) {
+        dot[0] += a[i] * b[i];
+        mag_a[0] += a[i] * a[i];
+        mag_b[0] += b[i] * b[i];
     }
+    float d = (dot[0] + dot[1]) + (dot[2] + dot[3]);
+    float ma = (mag_a[0] + mag_a[1]) + (mag_a[2] + mag_a[3]);
+    float mb = (mag_b[0] + mag_b[1]) + (mag_b[2] + mag_b[3]);
+    ma = (ma > 0) ? sqrtf(ma) : 1.0f;
+    mb = (mb > 0) ? sqrtf(mb) : 1.0f;
+    return (ma * mb > 0) ? (d / (ma * mb)) : 0.0f;
 }
 
-//---PHASE 3: Collective Consciousness Functions---
-static void initialize_collective_consciousness(void) {
-    collective.thought_count = 0;
-    collective.global_coherence = 0.0f;
-    for (uint32_t i = 0; i < MAX_THOUGHTS; i++) {
-        collective.thought_space[i].valid = 0;
+static void merge_average_unrolled(float* dest, const float* src, uint32_t dims) {
+    uint32_t i = 0;
+    for (; i + 4 <= dims; i += 4) {
+        dest[i] = (dest[i] + src[i]) * 0.5f;
+        dest[i + 1] = (dest[i + 1] + src[i + 1]) * 0.5f;
+        dest[i + 2] = (dest[i + 2] + src[i + 2]) * 0.5f;
+        dest[i + 3] = (dest[i + 3] + src[i + 3]) * 0.5f;
     }
-    serial_print("[COLLECTIVE] Consciousness initialized\n");
+    for (; i < dims; i++) dest[i] = (dest[i] + src[i]) * 0.5f;
 }
 
-static void broadcast_thought(HyperVector* thought) {
-    if (!thought || !thought->valid) return;
-    if (collective.thought_count >= MAX_THOUGHTS) {
-        // Evict oldest thought (simple LRU)
+// FNV-1a is a serial chain, so the only freedom is fetching four bytes at once.
+static uint32_t hash_fnv1a_words(const void* input, uint32_t size) {
+    const uint8_t* data = (const uint8_t*)input;
+    uint32_t hash = 2166136261U;
+    uint32_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        uint32_t word;
+        memcpy(&word, data + i, 4);
+        hash = (hash ^ (word & 0xFF)) * 16777619U;
+        hash = (hash ^ ((word >> 8) & 0xFF)) * 16777619U;
+        hash = (hash ^ ((word >> 16) & 0xFF)) * 16777619U;
+        hash = (hash ^ (word >> 24)) * 16777619U;
+    }
+    for (; i < size; i++) hash = (hash ^ data[i]) * 16777619U;
+    return hash;
+}
+
+#ifdef __x86_64__
+// SSE through GCC vector extensions. The 32-bit kernel never sets
+// CR4.OSFXSR, so there SSE instructions would fault and these are left out.
+typedef float v4sf __attribute__((vector_size(16)));
+typedef float v4sf_unaligned __attribute__((vector_size(16), aligned(4)));
+
+static float similarity_cosine_sse(const float* a, const float* b, uint32_t dims) {
+    v4sf dot = {0, 0, 0, 0}, mag_a = {0, 0, 0, 0}, mag_b = {0, 0, 0, 0};
+    uint32_t i = 0;
+    for (; i + 4 <= dims; i += 4) {
+        v4sf va = *(const v4sf_unaligned*)(a + i);
+        v4sf vb = *(const v4sf_unaligned*)(b + i);
+        dot += va * vb;
+        mag_a += va * va;
+        mag_b += vb * vb;
+    }
+    for (; i < dims; i++) {
+        dot[0] += a[i] * b[i];
+        mag_a[0] += a[i] * a[i];
+        mag_b[0] += b[i] * b[i];
+    }
+    float d = (dot[0] + dot[1]) + (dot[2] + dot[3]);
+    float ma = (mag_a[0] + mag_a[1]) + (mag_a[2] + mag_a[3]);
+    float mb = (mag_b[0] + mag_b[1]) + (mag_b[2] + mag_b[3]);
+    ma = (ma > 0) ? sqrtf(ma) : 1.0f;
+    mb = (mb > 0) ? sqrtf(mb) : 1.0f;
+    return (ma * mb > 0) ? (d / (ma * mb)) : 0.0f;
+}
+
+static void merge_average_sse(float* dest, const float* src, uint32_t dims) {
+    const v4sf half = {0.5f, 0.5f, 0.5f, 0.5f};
+    uint32_t i = 0;
+    for (; i + 4 <= dims; i += 4) {
+        v4sf_unaligned* d = (v4sf_unaligned*)(dest + i);
+        *d = (*d + *(const v4sf_unaligned*)(src + i)) * half;
+    }
+    for (; i < dims; i++) dest[i] = (dest[i] + src[i]) * 0.5f;
+}
+#endif
+
+static const struct DispatchVariant ca_rule_variants[] = {
+    {"reactive", (dispatch_fn)ca_rule_reactive},
+    {"parity", (dispatch_fn)ca_rule_parity},
+    {"sustain", (dispatch_fn)ca_rule_sustain},
+};
+static const struct DispatchVariant resonance_variants[] = {
+    {"threshold", (dispatch_fn)resonance_threshold},
+    {"confidence", (dispatch_fn)resonance_confidence},
+};
+static const struct DispatchVariant mutation_variants[] = {
+    {"dense", (dispatch_fn)mutation_dense},
+    {"sparse", (dispatch_fn)mutation_sparse},
+};
+static const struct DispatchVariant similarity_variants[] = {
+    {"cosine", (dispatch_fn)similarity_cosine},
+    {"unrolled", (dispatch_fn)similarity_cosine_unrolled},
+#ifdef __x86_64__
+    {"sse", (dispatch_fn)similarity_cosine_sse},
+#endif
+};
+static const struct DispatchVariant merge_variants[] = {
+    {"average", (dispatch_fn)merge_average},
+    {"unrolled", (dispatch_fn)merge_average_unrolled},
+#ifdef __x86_64__
+    {"sse", (dispatch_fn)merge_average_sse},
+#endif
+};
+static const struct DispatchVariant hash_variants[] = {
+    {"fnv1a", (dispatch_fn)hash_fnv1a},
+    {"words", (dispatch_fn)hash_fnv1a_words},
+};
+#define DISPATCH_VARIANTS(list) list, sizeof(list) / sizeof(list[0])
+static const struct DispatchSlot dispatch_slots[DISPATCH_SLOT_COUNT] = {
+    {"ca_rule", DISPATCH_VARIANTS(ca_rule_variants), 0},
+    {"resonance", DISPATCH_VARIANTS(resonance_variants), 0},
+    {"mutation", DISPATCH_VARIANTS(mutation_variants), 0},
+    {"similarity_small", DISPATCH_VARIANTS(similarity_variants), 128},
+    {"similarity_medium", DISPATCH_VARIANTS(similarity_variants), 512},
+    {"similarity_large", DISPATCH_VARIANTS(similarity_variants), MAX_DIMENSIONS},
+    {"merge_small", DISPATCH_VARIANTS(merge_variants), 128},
+    {"merge_medium", DISPATCH_VARIANTS(merge_variants), 512},
+    {"merge_large", DISPATCH_VARIANTS(merge_variants), MAX_DIMENSIONS},
+    {"hash_small", DISPATCH_VARIANTS(hash_variants), 128},
+    {"hash_medium", DISPATCH_VARIANTS(hash_variants), 512},
+    {"hash_large", DISPATCH_VARIANTS(hash_variants), MAX_DIMENSIONS},
+};
+static struct DispatchTable dispatch = {
+    {(dispatch_fn)ca_rule_reactive, (dispatch_fn)resonance_threshold, (dispatch_fn)mutation_dense,
+     (dispatch_fn)similarity_cosine, (dispatch_fn)similarity_cosine, (dispatch_fn)similarity_cosine,
+     (dispatch_fn)merge_average, (dispatch_fn)merge_average, (dispatch_fn)merge_average,
+     (dispatch_fn)hash_fnv1a, (dispatch_fn)hash_fnv1a, (dispatch_fn)hash_fnv1a},
+    0
+};
+
+static uint32_t dim_class(uint32_t dims) {
+    if (dims <= 128) return DIM_CLASS_SMALL;
+    return dims <= 512 ? DIM_CLASS_MEDIUM : DIM_CLASS_LARGE;
+}
+
+// Index of the variant a slot currently holds
+static uint32_t dispatch_variant_index(uint32_t slot) {
+    const struct DispatchSlot* info = &dispatch_slots[slot];
+    for (uint32_t v = 0; v < info->variant_count; v++) {
+        if (info->variants[v].fn == dispatch.fn[slot]) return v;
+    }
+    return 0;
+}
+
+// Called by the patch engine after every write and revert
+static void dispatch_note_write(uint32_t address) {
+    uintptr_t table = (uintptr_t)&dispatch.fn[0];
+    if (address >= table && address < table + sizeof(dispatch.fn)) dispatch.version++;
+}
+
+static int dispatch_propose_swap(uint32_t slot, uint32_t variant, uint32_t proposer) {
+    if (slot >= DISPATCH_SLOT_COUNT || variant >= dispatch_slots[slot].variant_count) return -1;
+    dispatch_fn fn = dispatch_slots[slot].variants[variant].fn;
+    return patch_enqueue((uint32_t)(uintptr_t)&dispatch.fn[slot], &fn, sizeof(fn), proposer,
+                         PATCH_PRIORITY_OPERATOR, 0) < 0 ? -1 : 0;
+}
+
+static float compute_similarity(HyperVector* a, HyperVector* b) {
+    if (!a || !b || !a->valid || !b->valid || !a->data || !b->data) {
+        return 0.0f;
+    }
+    uint32_t min_dims = (a->active_dims < b->active_dims) ? a->active_dims : b->active_dims;
+    if (min_dims == 0) return 0.0f;
+    return ((similarity_fn)dispatch.fn[DISPATCH_SIMILARITY + dim_class(min_dims)])(a->data, b->data, min_dims);
+}
+
+// Hash functions are keyed on vector contents, so they are classed by size in floats
+static uint32_t hash_data(const void* input, uint32_t size) {
+    return ((hash_fn)dispatch.fn[DISPATCH_HASH + dim_class(size / sizeof(float))])(input, size);
+}
+
+//---PHASE 2: Self-Modifying Genome Functions---
+static struct Gene* create_gene(const char* name, HyperVector pattern) {
+    struct Gene* gene = (struct Gene*)kmalloc(sizeof(struct Gene));
+    // --- ADD THIS CHECK ---
+    if (!gene) {
+        klog(LOG_SUB_GENOME, LOG_ERROR, "[ERROR] create_gene: Out of memory!\n");
+        return NULL;
+    }
+    gene->pattern = pattern;
+    gene->next = NULL;
+    gene->fitness = 0;
+    gene->mutable = 1;
+    strncpy(gene->name, name, 15);
+    gene->name[15] = '\0';
+    return gene;
+}
+
+static void mutate_gene(struct Gene* gene, float rate) {
+    if (!gene || !gene->mutable || !gene->pattern.valid) return;
+    uint32_t mutations = ((mutation_fn)dispatch.fn[DISPATCH_MUTATION])(
+        gene->pattern.data, gene->pattern.active_dims, rate, holo_system.global_timestamp);
+    if (mutations > 0) {
+        gene->fitness = 0; // Reset fitness after mutation
+        gene->pattern.hash_sig = hash_data(gene->pattern.data, gene->pattern.active_dims * sizeof(float));
+        klog(LOG_SUB_GENOME, LOG_INFO, "[MUTATE] Gene ");
+        klog(LOG_SUB_GENOME, LOG_INFO, gene->name);
+        klog(LOG_SUB_GENOME, LOG_INFO, " mutated ");
+        klog_hex(LOG_SUB_GENOME, LOG_INFO, mutations);
+        klog(LOG_SUB_GENOME, LOG_INFO, " dimensions\n");
+    }
+}
+
+static struct Gene* invent_gene(HyperVector pattern) {
+    struct Gene* new_gene = (struct Gene*)kmalloc(sizeof(struct Gene));
+    if (!new_gene) return NULL;
+    new_gene->pattern = pattern;
+    new_gene->next = NULL;
+    new_gene->fitness = 0;
+    new_gene->mutable = 1;
+    strncpy(new_gene->name, "invented", 15);
+    new_gene->name[15] = '\0';
+    return new_gene;
+}
+
+static void add_gene_to_entity(struct Entity* entity, struct Gene* gene) {
+    if (!entity || !gene || entity->gene_count >= MAX_GENES_PER_ENTITY) return;
+    // Add to front of linked list
+    gene->next = entity->genome;
+    entity->genome = gene;
+    entity->gene_count++;
+    klog(LOG_SUB_GENOME, LOG_DEBUG, "[GENOME] Added gene ");
+    klog(LOG_SUB_GENOME, LOG_DEBUG, gene->name);
+    klog(LOG_SUB_GENOME, LOG_DEBUG, " to entity ");
+    klog_hex(LOG_SUB_GENOME, LOG_DEBUG, entity->id);
+    klog(LOG_SUB_GENOME, LOG_DEBUG, "\n");
+}
+
+static void destroy_genome(struct Gene* genome) {
+    struct Gene* current = genome;
+    while (current) {
+        struct Gene* next = current->next;
+        destroy_hyper_vector(&current->pattern);
+        kfree(current);
+        current = next;
+    }
+}
+
+//---PHASE 3: Collective Consciousness Functions---
+static void initialize_collective_consciousness(void) {
+    collective.thought_count = 0;
+    collective.global_coherence = 0.0f;
+    for (uint32_t i = 0; i < MAX_THOUGHTS; i++) {
+        collective.thought_space[i].valid = 0;
+    }
+    klog(LOG_SUB_COLLECTIVE, LOG_INFO, "[COLLECTIVE] Consciousness initialized\n");
+}
+
+static void broadcast_thought(HyperVector* thought) {
+    if (!thought || !thought->valid) return;
+    if (collective.thought_count >= MAX_THOUGHTS) {
+        // Evict oldest thought (simple LRU)
         destroy_hyper_vector(&collective.thought_space[0]);
         for (uint32_t i = 0; i < MAX_THOUGHTS - 1; i++) {
             collective.thought_space[i] = collective.thought_space[i + 1];
@@ -562,9 +1869,9 @@ static void broadcast_thought(HyperVector* thought) {
     collective.thought_count++;
     float coherence = compute_coherence(thought);
     collective.global_coherence = (collective.global_coherence * 9.0f + coherence) / 10.0f;
-    serial_print("[BROADCAST] Thought added to collective, coherence: ");
-    print_hex((uint32_t)(coherence * 1000));
-    serial_print("\n");
+    klog(LOG_SUB_COLLECTIVE, LOG_DEBUG, "[BROADCAST] Thought added to collective, coherence: ");
+    klog_hex(LOG_SUB_COLLECTIVE, LOG_DEBUG, (uint32_t)(coherence * 1000));
+    klog(LOG_SUB_COLLECTIVE, LOG_DEBUG, "\n");
 }
 
 static float compute_coherence(HyperVector* thought) {
@@ -586,7 +1893,7 @@ static void encode_holographic_memory(HyperVector* input, HyperVector* output) {
             holo_system.memory_pool[i] = holo_system.memory_pool[i + 1];
         }
         holo_system.memory_count = MAX_MEMORY_ENTRIES - 1;
-        serial_print("Warning: Holographic memory full, evicted oldest entry.\n");
+        klog(LOG_SUB_MEMORY, LOG_WARN, "Warning: Holographic memory full, evicted oldest entry.\n");
     }
     MemoryEntry* entry = &holo_system.memory_pool[holo_system.memory_count];
     entry->input_pattern = *input;
@@ -596,18 +1903,6 @@ static void encode_holographic_memory(HyperVector* input, HyperVector* output) {
     holo_system.memory_count++;
 }
 
-static HyperVector* retrieve_holographic_memory(uint32_t hash) {
-    if (holo_system.memory_count > 0) {
-        for (uint32_t i = holo_system.memory_count - 1; i < MAX_MEMORY_ENTRIES; i--) {
-            if (holo_system.memory_pool[i].valid &&
-                holo_system.memory_pool[i].input_pattern.hash_sig == hash) {
-                return &holo_system.memory_pool[i].output_pattern;
-            }
-        }
-    }
-    return NULL;
-}
-
 static void initialize_holographic_memory(void) {
     print("Setting up hyperdimensional memory pool...\n");
     holo_system.memory_count = 0;
@@ -622,39 +1917,167 @@ static void initialize_holographic_memory(void) {
     print(".\n");
 }
 
-static void load_initial_genome_vocabulary(void) {
-    const char* vocab[] = {
-        "ACTION_PRODUCE", "ACTION_CONSUME", "ACTION_SHARE",
-        "ACTION_ACTIVATE", "ACTION_DEACTIVATE", "ACTION_SPAWN",
-        "TRAIT_GENERIC", "TRAIT_ACTIVE", "TRAIT_DORMANT",
-        "SENSOR_NEIGHBOR_ACTIVE", "SENSOR_MEMORY_MATCH",
-        "GENOME_SIMPLE_RULE_1", "GENOME_ADAPTIVE", "GENOME_SOCIAL"
-    };
-    const size_t num_vocab = sizeof(vocab) / sizeof(vocab[0]);
-    serial_print("Loading enhanced genome vocabulary...\n");
-    for (size_t i = 0; i < num_vocab; i++) {
-        HyperVector pattern = create_hyper_vector(vocab[i], strlen(vocab[i]) + 1);
-        encode_holographic_memory(&pattern, &pattern);
-        broadcast_thought(&pattern); // Add to collective consciousness
-        serial_print("  Loaded & broadcasted: ");
-        serial_print(vocab[i]);
-        serial_print("\n");
+//---Concept Registry: vocabulary names now, vectors on first use---
+// Registering a concept costs one hash and a name copy. Its HyperVector is
+// created (and encoded into holographic memory) the first time it is looked up,
+// so boot cost no longer depends on how large the vocabulary is.
+static const char* const genome_vocabulary[] = {
+    "ACTION_PRODUCE", "ACTION_CONSUME", "ACTION_SHARE",
+    "ACTION_ACTIVATE", "ACTION_DEACTIVATE", "ACTION_SPAWN",
+    "TRAIT_GENERIC", "TRAIT_ACTIVE", "TRAIT_DORMANT",
+    "SENSOR_NEIGHBOR_ACTIVE", "SENSOR_MEMORY_MATCH",
+    "GENOME_SIMPLE_RULE_1", "GENOME_ADAPTIVE", "GENOME_SOCIAL"
+};
+#define GENOME_VOCABULARY_SIZE (sizeof(genome_vocabulary) / sizeof(genome_vocabulary[0]))
+
+static uint32_t find_concept_hashed(const char* name, uint32_t hash) {
+    uint32_t bucket = hash & (CONCEPT_HASH_BUCKETS - 1);
+    while (concepts.buckets[bucket]) {
+        uint32_t index = concepts.buckets[bucket] - 1u;
+        const struct Concept* concept = &concepts.entries[index];
+        if (concept->name_hash == hash && str_equal(&concepts.names[concept->name_offset], name)) {
+            return index;
+        }
+        bucket = (bucket + 1) & (CONCEPT_HASH_BUCKETS - 1);
+    }
+    return CONCEPT_NONE;
+}
+
+// Returns the concept's index, registering the name if it is new, or CONCEPT_NONE if full.
+static uint32_t register_concept(const char* name) {
+    uint32_t length = (uint32_t)strlen(name);
+    uint32_t hash = hash_data(name, length + 1);
+    uint32_t index = find_concept_hashed(name, hash);
+    if (index != CONCEPT_NONE) return index;
+    if (concepts.count >= MAX_CONCEPTS || length + 1 > CONCEPT_NAME_POOL_SIZE - concepts.names_used) {
+        klog(LOG_SUB_GENOME, LOG_WARN, "[CONCEPT] Registry full, dropped ");
+        klog(LOG_SUB_GENOME, LOG_WARN, name);
+        klog(LOG_SUB_GENOME, LOG_WARN, "\n");
+        return CONCEPT_NONE;
+    }
+    index = concepts.count++;
+    struct Concept* concept = &concepts.entries[index];
+    concept->name_hash = hash;
+    concept->name_offset = concepts.names_used;
+    concept->vector = CONCEPT_NONE;
+    concept->association_count = 0;
+    concept->association_first = 0;
+    memcpy(&concepts.names[concepts.names_used], name, length + 1);
+    concepts.names_used += length + 1;
+    uint32_t bucket = hash & (CONCEPT_HASH_BUCKETS - 1);
+    while (concepts.buckets[bucket]) {
+        bucket = (bucket + 1) & (CONCEPT_HASH_BUCKETS - 1);
     }
-    serial_print("Enhanced genome vocabulary loaded into collective.\n");
+    concepts.buckets[bucket] = (uint16_t)(index + 1);
+    return index;
+}
+
+static HyperVector* materialize_concept(uint32_t index) {
+    struct Concept* concept = &concepts.entries[index];
+    if (concept->vector != CONCEPT_NONE) return &concepts.vectors[concept->vector];
+    if (concepts.materialized >= MAX_MATERIALIZED_CONCEPTS) {
+        klog(LOG_SUB_GENOME, LOG_WARN, "[CONCEPT] Materialization limit reached\n");
+        return NULL;
+    }
+    const char* name = &concepts.names[concept->name_offset];
+    HyperVector vec = create_hyper_vector(name, strlen(name) + 1);
+    if (!vec.valid) return NULL;
+    // Corpus associations are bundled in from their seeds, so they need no vectors of their own
+    for (uint32_t i = 0; i < concept->association_count; i++) {
+        const struct Concept* other = &concepts.entries[concepts.associations[concept->association_first + i]];
+        add_seeded_pattern(vec.data, vec.capacity, other->name_hash, CONCEPT_ASSOCIATION_WEIGHT);
+    }
+    if (concept->association_count) {
+        vec.hash_sig = hash_data(vec.data, vec.active_dims * sizeof(float));
+    }
+    encode_holographic_memory(&vec, &vec);
+    concept->vector = (uint16_t)concepts.materialized++;
+    concepts.vectors[concept->vector] = vec;
+    klog(LOG_SUB_GENOME, LOG_DEBUG, "[CONCEPT] Materialized ");
+    klog(LOG_SUB_GENOME, LOG_DEBUG, name);
+    klog(LOG_SUB_GENOME, LOG_DEBUG, "\n");
+    return &concepts.vectors[concept->vector];
+}
+
+// The concept's vector, built on first use. Unregistered names are registered.
+static HyperVector* lookup_concept(const char* name) {
+    uint32_t index = register_concept(name);
+    return (index == CONCEPT_NONE) ? NULL : materialize_concept(index);
+}
+
+static void register_genome_vocabulary(void) {
+    for (uint32_t i = 0; i < GENOME_VOCABULARY_SIZE; i++) {
+        register_concept(genome_vocabulary[i]);
+    }
+    klog(LOG_SUB_GENOME, LOG_INFO, "[CONCEPT] Registered ");
+    klog_dec(LOG_SUB_GENOME, LOG_INFO, concepts.count);
+    klog(LOG_SUB_GENOME, LOG_INFO, " vocabulary concepts (vectors built on first use)\n");
+}
+
+// Broadcasts the first VOCAB_SEED_THOUGHTS concepts without per-thought
+// coherence updates, then sets global_coherence once for the whole batch.
+static void seed_collective_with_vocabulary(void) {
+    uint32_t seeded = 0;
+    for (uint32_t i = 0; i < concepts.count && seeded < VOCAB_SEED_THOUGHTS; i++) {
+        if (collective.thought_count >= MAX_THOUGHTS) break;
+        HyperVector* vec = materialize_concept(i);
+        if (!vec) continue;
+        collective.thought_space[collective.thought_count++] = *vec;
+        seeded++;
+    }
+    collective.global_coherence = compute_batch_coherence();
+    klog(LOG_SUB_GENOME, LOG_INFO, "[CONCEPT] Seeded collective with ");
+    klog_dec(LOG_SUB_GENOME, LOG_INFO, seeded);
+    klog(LOG_SUB_GENOME, LOG_INFO, " concepts, coherence x1000: ");
+    klog_dec(LOG_SUB_GENOME, LOG_INFO, (uint32_t)(collective.global_coherence * 1000));
+    klog(LOG_SUB_GENOME, LOG_INFO, "\n");
+}
+
+// Mean pairwise cosine similarity of the thought space. Each thought's norm
+// is computed once rather than once per pair as compute_similarity() would.
+static float compute_batch_coherence(void) {
+    float norms[MAX_THOUGHTS];
+    uint32_t n = collective.thought_count;
+    if (n < 2) return 1.0f;
+    for (uint32_t i = 0; i < n; i++) {
+        const HyperVector* v = &collective.thought_space[i];
+        float sum = 0.0f;
+        if (v->valid && v->data) {
+            for (uint32_t d = 0; d < v->active_dims; d++) {
+                sum += v->data[d] * v->data[d];
+            }
+        }
+        norms[i] = (sum > 0.0f) ? sqrtf(sum) : 0.0f;
+    }
+    float total = 0.0f;
+    uint32_t pairs = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        const HyperVector* a = &collective.thought_space[i];
+        for (uint32_t j = i + 1; j < n; j++) {
+            const HyperVector* b = &collective.thought_space[j];
+            pairs++;
+            if (norms[i] == 0.0f || norms[j] == 0.0f) continue;
+            uint32_t dims = (a->active_dims < b->active_dims) ? a->active_dims : b->active_dims;
+            float dot = 0.0f;
+            for (uint32_t d = 0; d < dims; d++) {
+                dot += a->data[d] * b->data[d];
+            }
+            total += dot / (norms[i] * norms[j]);
+        }
+    }
+    return total / (float)pairs;
 }
 
 static void initialize_emergent_entities(void) {
-    serial_print("Initializing emergent entity pool with dynamic genomes...\n");
-    HyperVector simple_genome_rule = create_hyper_vector("GENOME_ADAPTIVE", strlen("GENOME_ADAPTIVE") + 1);
-    HyperVector* genome_ptr = retrieve_holographic_memory(simple_genome_rule.hash_sig);
+    klog(LOG_SUB_ENTITY, LOG_INFO, "Initializing emergent entity pool with dynamic genomes...\n");
+    HyperVector* genome_ptr = lookup_concept("GENOME_ADAPTIVE");
     if (!genome_ptr) {
-        serial_print("Creating new adaptive genome rule...\n");
-        encode_holographic_memory(&simple_genome_rule, &simple_genome_rule);
-        genome_ptr = &simple_genome_rule;
+        klog(LOG_SUB_ENTITY, LOG_ERROR, "Error: No adaptive genome rule, entities not created.\n");
+        return;
     }
     for (uint32_t i = 0; i < (uint32_t)INITIAL_ENTITIES; i++) {
         if (active_entity_count >= MAX_ENTITIES) {
-            serial_print("Error: Cannot initialize more entities, pool full.\n");
+            klog(LOG_SUB_ENTITY, LOG_ERROR, "Error: Cannot initialize more entities, pool full.\n");
             break;
         }
         struct Entity* entity = &entity_pool[active_entity_count];
@@ -681,24 +2104,24 @@ static void initialize_emergent_entities(void) {
         entity->marked_for_gc = 0;
         entity->is_mutant = 0;
         entity->task_alignment = 0.0f;
-        entity->mutation_rate = 50; // 5% default mutation rate
+        entity->mutation_rate = params.mutation_rate; // 5% by default
         strncpy(entity->domain_name, "adaptive", 31);
         entity->domain_name[31] = '\0';
         active_entity_count++;
-        serial_print("  Initialized adaptive entity ID: ");
-        print_hex(entity->id);
-        serial_print(" with ");
-        print_hex(entity->gene_count);
-        serial_print(" genes\n");
+        klog(LOG_SUB_ENTITY, LOG_INFO, "  Initialized adaptive entity ID: ");
+        klog_hex(LOG_SUB_ENTITY, LOG_INFO, entity->id);
+        klog(LOG_SUB_ENTITY, LOG_INFO, " with ");
+        klog_hex(LOG_SUB_ENTITY, LOG_INFO, entity->gene_count);
+        klog(LOG_SUB_ENTITY, LOG_INFO, " genes\n");
     }
-    serial_print("Initialized ");
-    print_hex(active_entity_count);
-    serial_print(" adaptive entities with dynamic genomes.\n");
+    klog(LOG_SUB_ENTITY, LOG_INFO, "Initialized ");
+    klog_hex(LOG_SUB_ENTITY, LOG_INFO, active_entity_count);
+    klog(LOG_SUB_ENTITY, LOG_INFO, " adaptive entities with dynamic genomes.\n");
 }
 
 static struct Entity* spawn_entity(void) {
     if (active_entity_count >= MAX_ENTITIES) {
-        serial_print("Cannot spawn: Entity pool full.\n");
+        klog(LOG_SUB_ENTITY, LOG_WARN, "Cannot spawn: Entity pool full.\n");
         return NULL;
     }
     struct Entity* new_entity = &entity_pool[active_entity_count];
@@ -712,7 +2135,7 @@ static struct Entity* spawn_entity(void) {
     new_entity->is_mutant = 1; // Spawned entities are mutants
     new_entity->gene_count = 0;
     new_entity->genome = NULL;
-    new_entity->mutation_rate = 100; // Higher mutation rate for spawned entities
+    new_entity->mutation_rate = params.spawn_mutation_rate; // Higher mutation rate for spawned entities
     // Create adaptive state
     new_entity->state = create_hyper_vector("TRAIT_EMERGENT", strlen("TRAIT_EMERGENT") + 1);
     // Create initial gene
@@ -727,12 +2150,333 @@ static struct Entity* spawn_entity(void) {
     strncpy(new_entity->domain_name, "spawned", 31);
     new_entity->domain_name[31] = '\0';
     active_entity_count++;
-    serial_print("[SPAWN] SUCCESS: New adaptive entity ID ");
-    print_hex(new_entity->id);
-    serial_print(" with dynamic genome.\n");
+    sim_stats.spawns++;
+    klog(LOG_SUB_ENTITY, LOG_INFO, "[SPAWN] SUCCESS: New adaptive entity ID ");
+    klog_hex(LOG_SUB_ENTITY, LOG_INFO, new_entity->id);
+    klog(LOG_SUB_ENTITY, LOG_INFO, " with dynamic genome.\n");
     return new_entity;
 }
 
+// --- GENE RULES AND JIT ---
+// An entity's genome encodes a small rule over its sensors: the genome hash
+// seeds a chain of hashes that decodes into RULE_OP_* instructions, so any
+// gene mutation yields a new rule. The JIT turns a rule into x86 code in a
+// fixed arena, cached by genome hash; entities with the same genes share
+// code. The generated code uses eax/ecx/edx and no REX prefixes, so the same
+// bytes run in both builds apart from the prologue that fetches the sensor
+// pointer. A rule's output (the drive) overrides the CA rule when its
+// magnitude reaches RULE_DRIVE_THRESHOLD. Compare immediates in generated
+// code are what self-modification tunes. The VM runs the same programs
+// without generating code.
+
+static uint32_t genome_hash(const struct Entity* entity) {
+    uint32_t hash = 2166136261U;
+    for (const struct Gene* gene = entity->genome; gene; gene = gene->next) {
+        hash = (hash ^ gene->pattern.hash_sig) * 16777619U;
+    }
+    return hash ? hash : 1;      // 0 marks an empty cache entry
+}
+
+static void rule_decode(uint32_t key, struct RuleProgram* program) {
+    uint32_t h = key;
+    h = hash_data(&h, sizeof(h));
+    program->length = 3 + h % (RULE_MAX_OPS - 2);
+    for (uint32_t i = 0; i < program->length; i++) {
+        struct RuleOp* op = &program->ops[i];
+        h = hash_data(&h, sizeof(h));
+        op->op = (uint8_t)(h % RULE_OP_COUNT);
+        op->arg = (uint8_t)((h >> 8) % RULE_SENSOR_COUNT);
+        op->imm = (int32_t)((h >> 16) % 2001) - 1000;
+        if (i == 0) op->op = RULE_OP_LOAD;           // Start from a sensor, not from 0
+        if (op->op == RULE_OP_SKIP_LE) {
+            // Skip at most to the end; a skip with nowhere to go is a threshold
+            op->arg = (uint8_t)(1 + op->arg % 3);
+            if (i + 1 + op->arg > program->length) op->arg = (uint8_t)(program->length - 1 - i);
+            if (op->arg == 0) op->op = RULE_OP_THRESH;
+        }
+    }
+}
+
+static void jit_emit8(uint8_t** p, uint8_t value) {
+    *(*p)++ = value;
+}
+
+static void jit_emit32(uint8_t** p, int32_t value) {
+    memcpy(*p, &value, 4);
+    *p += 4;
+}
+
+// Compiles to code, which must have JIT_MAX_CODE bytes. Returns the length
+// and sets *tune_offset to the first compare's imm32, else the first other
+// immediate (0 if the rule has none).
+static uint32_t jit_compile(const struct RuleProgram* program, uint8_t* code, uint16_t* tune_offset) {
+    uint8_t* p = code;
+    uint32_t op_offset[RULE_MAX_OPS + 1];
+    uint8_t* fixup[RULE_MAX_OPS];
+    uint16_t first_imm = 0;
+    *tune_offset = 0;
+#ifdef __x86_64__
+    jit_emit8(&p, 0x48); jit_emit8(&p, 0x89); jit_emit8(&p, 0xFA);    // mov rdx, rdi
+#else
+    jit_emit8(&p, 0x8B); jit_emit8(&p, 0x54); jit_emit8(&p, 0x24); jit_emit8(&p, 0x04); // mov edx, [esp+4]
+#endif
+    jit_emit8(&p, 0x31); jit_emit8(&p, 0xC0);                          // xor eax, eax
+    for (uint32_t i = 0; i < program->length; i++) {
+        const struct RuleOp* op = &program->ops[i];
+        op_offset[i] = (uint32_t)(p - code);
+        fixup[i] = NULL;
+        switch (op->op) {
+        case RULE_OP_LOAD:                                              // mov eax, [rdx+4*arg]
+            jit_emit8(&p, 0x8B); jit_emit8(&p, 0x42); jit_emit8(&p, (uint8_t)(op->arg * 4));
+            break;
+        case RULE_OP_ADD:                                               // add eax, [rdx+4*arg]
+            jit_emit8(&p, 0x03); jit_emit8(&p, 0x42); jit_emit8(&p, (uint8_t)(op->arg * 4));
+            break;
+        case RULE_OP_SUB:                                               // sub eax, [rdx+4*arg]
+            jit_emit8(&p, 0x2B); jit_emit8(&p, 0x42); jit_emit8(&p, (uint8_t)(op->arg * 4));
+            break;
+        case RULE_OP_ADDI:                                              // add eax, imm32
+            jit_emit8(&p, 0x05);
+            if (!first_imm) first_imm = (uint16_t)(p - code);
+            jit_emit32(&p, op->imm);
+            break;
+        case RULE_OP_SCALE:                                             // imul eax, eax, imm32; sar eax, 10
+            jit_emit8(&p, 0x69); jit_emit8(&p, 0xC0);
+            if (!first_imm) first_imm = (uint16_t)(p - code);
+            jit_emit32(&p, op->imm);
+            jit_emit8(&p, 0xC1); jit_emit8(&p, 0xF8); jit_emit8(&p, 10);
+            break;
+        case RULE_OP_THRESH:                                            // cmp eax, imm32; setg al; movzx eax, al
+            jit_emit8(&p, 0x3D);
+            if (!*tune_offset) *tune_offset = (uint16_t)(p - code);
+            jit_emit32(&p, op->imm);
+            jit_emit8(&p, 0x0F); jit_emit8(&p, 0x9F); jit_emit8(&p, 0xC0);
+            jit_emit8(&p, 0x0F); jit_emit8(&p, 0xB6); jit_emit8(&p, 0xC0);
+            break;
+        case RULE_OP_SKIP_LE:                                           // cmp eax, imm32; jle rel32
+            jit_emit8(&p, 0x3D);
+            if (!*tune_offset) *tune_offset = (uint16_t)(p - code);
+            jit_emit32(&p, op->imm);
+            jit_emit8(&p, 0x0F); jit_emit8(&p, 0x8E);
+            fixup[i] = p;
+            jit_emit32(&p, 0);
+            break;
+        default:                                                        // RULE_OP_RET
+            jit_emit8(&p, 0xC3);
+            break;
+        }
+    }
+    op_offset[program->length] = (uint32_t)(p - code);
+    jit_emit8(&p, 0xC3);                                                // ret
+    if (!*tune_offset) *tune_offset = first_imm;
+    for (uint32_t i = 0; i < program->length; i++) {
+        if (!fixup[i]) continue;
+        uint32_t target = i + 1 + program->ops[i].arg;
+        if (target > program->length) target = program->length;
+        int32_t rel = (int32_t)op_offset[target] - (int32_t)(fixup[i] + 4 - code);
+        memcpy(fixup[i], &rel, 4);
+    }
+    return (uint32_t)(p - code);
+}
+
+static void jit_flush(void) {
+    patch_forget_range((uint32_t)(uintptr_t)jit_arena, (uint32_t)(uintptr_t)jit_arena + JIT_ARENA_SIZE);
+    memset(jit.cache, 0, sizeof(jit.cache));
+    jit.used = 0;
+    jit.entries = 0;
+    jit.flushes++;
+    klog(LOG_SUB_GENOME, LOG_INFO, "[JIT] Code arena flushed\n");
+}
+
+// Compiled rule for a genome hash, compiling it on a miss.
+static const struct JitCacheEntry* jit_lookup(uint32_t key) {
+    uint32_t bucket = key & (JIT_CACHE_SIZE - 1);
+    while (jit.cache[bucket].key && jit.cache[bucket].key != key) {
+        bucket = (bucket + 1) & (JIT_CACHE_SIZE - 1);
+    }
+    if (jit.cache[bucket].key == key) {
+        jit.hits++;
+        return &jit.cache[bucket];
+    }
+    // Keep the table at most half full and the arena able to take one more rule
+    if (jit.entries >= JIT_CACHE_SIZE / 2 || jit.used + JIT_MAX_CODE > JIT_ARENA_SIZE) {
+        jit_flush();
+        bucket = key & (JIT_CACHE_SIZE - 1);
+    }
+    struct RuleProgram program;
+    struct JitCacheEntry* entry = &jit.cache[bucket];
+    rule_decode(key, &program);
+    entry->key = key;
+    entry->offset = jit.used;
+    entry->length = (uint16_t)jit_compile(&program, jit_arena + jit.used, &entry->tune_offset);
+    jit.used += (entry->length + 15) & ~15U;
+    jit.entries++;
+    jit.compiles++;
+    serialize_execution();
+    return entry;
+}
+
+// Checks that a program only names existing operations and sensors and
+// that every skip lands inside it. Branches only go forward, so a verified
+// program runs at most length instructions.
+static int rule_verify(const struct RuleProgram* program) {
+    if (program->length == 0 || program->length > RULE_MAX_OPS) return -1;
+    for (uint32_t i = 0; i < program->length; i++) {
+        const struct RuleOp* op = &program->ops[i];
+        if (op->op >= RULE_OP_COUNT) return -1;
+        if (op->op <= RULE_OP_SUB && op->arg >= RULE_SENSOR_COUNT) return -1;
+        if (op->op == RULE_OP_SKIP_LE && (op->arg == 0 || i + 1 + op->arg > program->length)) return -1;
+    }
+    return 0;
+}
+
+// Runs one verified program for `lanes` entities, one instruction at a
+// time across all lanes, so dispatch is paid once per instruction rather
+// than once per entity. A lane takes part from instruction resume[l] on;
+// a taken skip or a return moves that forward. The accumulators live in
+// out[].
+static void vm_run_batch(const struct RuleProgram* program, int32_t (*sensors)[RULE_SENSOR_COUNT],
+                         uint32_t lanes, int32_t* out) {
+    static const void* const handlers[RULE_OP_COUNT] = {
+        &&op_load, &&op_add, &&op_sub, &&op_addi, &&op_scale, &&op_thresh, &&op_skip_le, &&op_ret
+    };
+    struct VmInsn code[RULE_MAX_OPS + 1];
+    uint8_t resume[MAX_ENTITIES];
+    const struct VmInsn* insn = code;
+    uint8_t pc = 0;
+    for (uint32_t i = 0; i < program->length; i++) {
+        code[i].handler = handlers[program->ops[i].op];
+        code[i].arg = program->ops[i].arg;
+        code[i].imm = program->ops[i].imm;
+    }
+    code[program->length].handler = &&halt;
+    for (uint32_t l = 0; l < lanes; l++) {
+        out[l] = 0;
+        resume[l] = 0;
+    }
+    vm.batches++;
+    vm.lanes += lanes;
+    goto *insn->handler;
+
+#define VM_LANES for (uint32_t l = 0; l < lanes; l++) if (resume[l] <= pc)
+#define VM_DISPATCH do { vm.dispatches++; insn++; pc++; goto *insn->handler; } while (0)
+op_load:
+    VM_LANES out[l] = sensors[l][insn->arg];
+    VM_DISPATCH;
+op_add:
+    VM_LANES out[l] = (int32_t)((uint32_t)out[l] + (uint32_t)sensors[l][insn->arg]);
+    VM_DISPATCH;
+op_sub:
+    VM_LANES out[l] = (int32_t)((uint32_t)out[l] - (uint32_t)sensors[l][insn->arg]);
+    VM_DISPATCH;
+op_addi:
+    VM_LANES out[l] = (int32_t)((uint32_t)out[l] + (uint32_t)insn->imm);
+    VM_DISPATCH;
+op_scale:
+    VM_LANES out[l] = (int32_t)((uint32_t)out[l] * (uint32_t)insn->imm) >> 10;
+    VM_DISPATCH;
+op_thresh:
+    VM_LANES out[l] = out[l] > insn->imm;
+    VM_DISPATCH;
+op_skip_le:
+    VM_LANES if (out[l] <= insn->imm) resume[l] = (uint8_t)(pc + 1 + insn->arg);
+    VM_DISPATCH;
+op_ret:
+    VM_LANES resume[l] = (uint8_t)program->length;
+    VM_DISPATCH;
+#undef VM_LANES
+#undef VM_DISPATCH
+halt:
+    return;
+}
+
+// Active entities among the two ring neighbours of slot i
+static uint32_t active_neighbors(uint32_t i) {
+    uint32_t prev_idx = (i == 0) ? (active_entity_count - 1) : (i - 1);
+    uint32_t next_idx = (i == active_entity_count - 1) ? 0 : (i + 1);
+    return (uint32_t)entity_pool[prev_idx].is_active + entity_pool[next_idx].is_active;
+}
+
+static void rule_sensors(const struct Entity* entity, uint32_t neighbor_active, int32_t* sensors) {
+    const HyperVector* newest = holo_system.memory_count
+        ? &holo_system.memory_pool[holo_system.memory_count - 1].output_pattern : NULL;
+    sensors[RULE_SENSOR_NEIGHBORS] = (int32_t)neighbor_active * 1000;
+    sensors[RULE_SENSOR_ACTIVE] = entity->is_active ? 1000 : 0;
+    sensors[RULE_SENSOR_COHERENCE] = (int32_t)(collective.global_coherence * 1000.0f);
+    sensors[RULE_SENSOR_MEMORY_MATCH] = newest
+        ? (int32_t)(compute_similarity((HyperVector*)&entity->state, (HyperVector*)newest) * 1000.0f) : 0;
+    sensors[RULE_SENSOR_CONFIDENCE] = (int32_t)(entity->confidence * 1000.0f);
+    // Saturate the unbounded counters into the 0..1000 range of the others, so
+    // a rule that loads one does not drift past RULE_DRIVE_THRESHOLD for good
+    sensors[RULE_SENSOR_FITNESS] = (int32_t)(entity->fitness_score < 1000 ? entity->fitness_score : 1000);
+    sensors[RULE_SENSOR_AGE] = (int32_t)(entity->age < 1000 ? entity->age : 1000);
+    sensors[RULE_SENSOR_THOUGHTS] = (int32_t)(collective.thought_count * 1000 / MAX_THOUGHTS);
+}
+
+// Fills rule_drive[] from the state at the start of the update cycle.
+// The VM evaluates all entities sharing a genome as one batch.
+static void rules_evaluate_all(void) {
+    uint32_t keys[MAX_ENTITIES];
+    for (uint32_t i = 0; i < active_entity_count; i++) {
+        rule_drive[i] = 0;
+        keys[i] = (params.gene_rules && entity_pool[i].genome) ? genome_hash(&entity_pool[i]) : 0;
+        if (keys[i]) rule_sensors(&entity_pool[i], active_neighbors(i), rule_sensor_file[i]);
+    }
+    if (params.gene_rules == RULE_EXEC_JIT) {
+        for (uint32_t i = 0; i < active_entity_count; i++) {
+            if (!keys[i]) continue;
+            const struct JitCacheEntry* entry = jit_lookup(keys[i]);
+            rule_drive[i] = ((jit_rule_fn)(uintptr_t)(jit_arena + entry->offset))(rule_sensor_file[i]);
+        }
+    } else if (params.gene_rules == RULE_EXEC_VM) {
+        int32_t batch_sensors[MAX_ENTITIES][RULE_SENSOR_COUNT];
+        int32_t batch_out[MAX_ENTITIES];
+        uint8_t lane_entity[MAX_ENTITIES];
+        for (uint32_t i = 0; i < active_entity_count; i++) {
+            if (!keys[i]) continue;
+            uint32_t key = keys[i];
+            uint32_t lanes = 0;
+            for (uint32_t j = i; j < active_entity_count; j++) {
+                if (keys[j] != key) continue;
+                memcpy(batch_sensors[lanes], rule_sensor_file[j], sizeof(batch_sensors[0]));
+                lane_entity[lanes++] = (uint8_t)j;
+                keys[j] = 0;
+            }
+            struct RuleProgram program;
+            rule_decode(key, &program);
+            if (rule_verify(&program) != 0) {
+                vm.rejected++;
+                continue;
+            }
+            vm_run_batch(&program, batch_sensors, lanes, batch_out);
+            for (uint32_t l = 0; l < lanes; l++) rule_drive[lane_entity[l]] = batch_out[l];
+        }
+    }
+    for (uint32_t i = 0; i < active_entity_count; i++) {
+        if (rule_drive[i] > RULE_DRIVE_LIMIT) rule_drive[i] = RULE_DRIVE_LIMIT;
+        if (rule_drive[i] < -RULE_DRIVE_LIMIT) rule_drive[i] = -RULE_DRIVE_LIMIT;
+    }
+}
+
+// Proposes nudging the tunable immediate in the entity's compiled rule.
+// Only the JIT sees the result: the VM decodes rules from the genome hash,
+// so a committed tweak makes the two diverge for that genome.
+static void jit_propose_tweak(struct Entity* entity) {
+    const struct JitCacheEntry* entry = jit_lookup(genome_hash(entity));
+    if (!entry->tune_offset) return;
+    uint8_t* target = jit_arena + entry->offset + entry->tune_offset;
+    int32_t value;
+    memcpy(&value, target, 4);
+    value += (entity->age & 2) ? JIT_TWEAK_STEP : -JIT_TWEAK_STEP;
+    propose_kernel_patch(entity, (uint32_t)(uintptr_t)target, &value, sizeof(value),
+                         "RULE_CONSTANT", (entity->age & 2) ? "RULE_RAISE" : "RULE_LOWER");
+    klog(LOG_SUB_PATCH, LOG_INFO, "[SELF-MOD] Entity ");
+    klog_hex(LOG_SUB_PATCH, LOG_INFO, entity->id);
+    klog(LOG_SUB_PATCH, LOG_INFO, value < 0 ? " proposed a rule constant of -" : " proposed a rule constant of ");
+    klog_dec(LOG_SUB_PATCH, LOG_INFO, (uint32_t)(value < 0 ? -value : value));
+    klog(LOG_SUB_PATCH, LOG_INFO, "\n");
+}
+
 // --- ENHANCED: Update Loop with Hyperdimensional Evolution ---
 static void update_entities(void) {
     // Clear the arrays before use
@@ -755,7 +2499,8 @@ static void update_entities(void) {
         next_path_id[i] = 0;
         next_task_alignment[i] = 0.0f;
     }
-    serial_print("[EVOLUTION] Starting hyperdimensional update cycle...\n");
+    klog(LOG_SUB_ENTITY, LOG_INFO, "[EVOLUTION] Starting hyperdimensional update cycle...\n");
+    rules_evaluate_all();
     for (uint32_t i = 0; i < active_entity_count; i++) {
         struct Entity* entity = &entity_pool[i];
         next_active[i] = entity->is_active;
@@ -766,28 +2511,27 @@ static void update_entities(void) {
         next_path_id[i] = entity->path_id;
         next_task_alignment[i] = entity->task_alignment;
         entity->age++;
-        // Count active neighbors
-        uint32_t neighbor_active = 0;
-        uint32_t prev_idx = (i == 0) ? (active_entity_count - 1) : (i - 1);
-        uint32_t next_idx = (i == active_entity_count - 1) ? 0 : (i + 1);
-        if (entity_pool[prev_idx].is_active) neighbor_active++;
-        if (entity_pool[next_idx].is_active) neighbor_active++;
+        uint32_t neighbor_active = active_neighbors(i);
         // Listen to collective consciousness
         for (uint32_t t = 0; t < collective.thought_count; t++) {
             float similarity = compute_similarity(&entity->state, &collective.thought_space[t]);
-            if (similarity > 0.6f) {
+            if (((resonance_fn)dispatch.fn[DISPATCH_RESONANCE])(entity, similarity)) {
                 entity->confidence += 0.05f * similarity;
                 entity->resource_allocation += 0.1f;
                 entity->fitness_score += 2;
+                sim_stats.resonances++;
                 // Merge with resonant thought
                 merge_hyper_vectors(&entity->state, &collective.thought_space[t]);
-                serial_print("[RESONATE] Entity ");
-                print_hex(entity->id);
-                serial_print(" resonated with collective thought\n");
+                klog(LOG_SUB_ENTITY, LOG_DEBUG, "[RESONATE] Entity ");
+                klog_hex(LOG_SUB_ENTITY, LOG_DEBUG, entity->id);
+                klog(LOG_SUB_ENTITY, LOG_DEBUG, " resonated with collective thought\n");
             }
         }
         // Cellular Automata Rules with Hyperdimensional Evolution
-        if (!entity->is_active && neighbor_active > 0) {
+        uint8_t ca_next = ((ca_rule_fn)dispatch.fn[DISPATCH_CA_RULE])(entity->is_active, neighbor_active);
+        if (rule_drive[i] >= RULE_DRIVE_THRESHOLD) ca_next = 1;
+        if (rule_drive[i] <= -RULE_DRIVE_THRESHOLD) ca_next = 0;
+        if (!entity->is_active && ca_next) {
             next_active[i] = 1;
             next_state[i] = create_hyper_vector("TRAIT_ACTIVE", strlen("TRAIT_ACTIVE") + 1);
             strncpy(next_domain[i], "reactor", 31);
@@ -796,40 +2540,51 @@ static void update_entities(void) {
             entity->fitness_score += 5;
             // Broadcast activation to collective
             broadcast_thought(&next_state[i]);
-            serial_print("[ACTIVATE] Entity ");
-            print_hex(entity->id);
-            serial_print(" activated by neighbor.\n");
-        } else if (entity->is_active && neighbor_active == 0) {
+            klog(LOG_SUB_ENTITY, LOG_INFO, "[ACTIVATE] Entity ");
+            klog_hex(LOG_SUB_ENTITY, LOG_INFO, entity->id);
+            klog(LOG_SUB_ENTITY, LOG_INFO, " activated by neighbor.\n");
+        } else if (entity->is_active && !ca_next) {
             next_active[i] = 0;
             next_state[i] = create_hyper_vector("TRAIT_DORMANT", strlen("TRAIT_DORMANT") + 1);
             strncpy(next_domain[i], "sleeper", 31);
             next_domain[i][31] = '\0';
             entity->interaction_count++;
-            serial_print("[SLEEP] Entity ");
-            print_hex(entity->id);
-            serial_print(" going dormant (no neighbors).\n");
+            klog(LOG_SUB_ENTITY, LOG_INFO, "[SLEEP] Entity ");
+            klog_hex(LOG_SUB_ENTITY, LOG_INFO, entity->id);
+            klog(LOG_SUB_ENTITY, LOG_INFO, " going dormant (no neighbors).\n");
         }
         // --- PHASE 4: SELF-MODIFICATION TRIGGER ---
-        // Let's say an entity with high confidence and fitness tries to patch the kernel
-        // We'll target a safe, non-critical location in the heap (e.g., the entity_pool array)
-        // This is a demonstration. In a real system, this would be a function pointer.
-        if (entity->confidence > 0.8f && entity->fitness_score > 50 && entity->mutation_rate > 100) {
-            // Create a "before" state: the current state of the entity's own `is_active` flag
-            // This is a placeholder. In reality, you'd hash a function's assembly signature.
-            HyperVector before_state = create_hyper_vector("ENTITY_ACTIVE_FLAG", strlen("ENTITY_ACTIVE_FLAG") + 1);
-            // Create a "replacement" state: a pattern that means "become dormant"
-            HyperVector after_state = create_hyper_vector("ENTITY_DORMANT_FLAG", strlen("ENTITY_DORMANT_FLAG") + 1);
-            // Propose a patch to change the entity's own `is_active` flag
-            // The address is a pointer to the `is_active` field of this entity.
-            // This is a very simplified example.
-            uintptr_t target_address = (uintptr_t)&entity->is_active;
-            propose_kernel_patch(entity, &before_state, &after_state, (uint32_t)target_address);
+        // An entity with high confidence and fitness proposes to switch one
+        // dispatch slot to its next variant, or at odd ages to retune its
+        // compiled gene rule. The patch engine commits it at the cycle
+        // boundary and reverts it if the population regresses.
+        if (entity->confidence * 1000.0f > (float)params.patch_confidence &&
+            entity->fitness_score > params.patch_fitness &&
+            entity->mutation_rate > params.patch_mutation_rate) {
+            if (params.gene_rules == RULE_EXEC_JIT && entity->genome && (entity->age & 1)) {
+                // Odd ages tune the entity's own compiled rule instead
+                jit_propose_tweak(entity);
+                entity->confidence = 0.5f;
+                entity->fitness_score = 0;
+                continue;
+            }
+            uint32_t slot = (entity->id + entity->age) % DISPATCH_RULE_SLOTS;
+            uint32_t variant = (dispatch_variant_index(slot) + 1) % dispatch_slots[slot].variant_count;
+            const struct DispatchVariant* current = &dispatch_slots[slot].variants[dispatch_variant_index(slot)];
+            const struct DispatchVariant* proposed = &dispatch_slots[slot].variants[variant];
+            dispatch_fn fn = proposed->fn;
+            propose_kernel_patch(entity, (uint32_t)(uintptr_t)&dispatch.fn[slot], &fn, sizeof(fn),
+                                 current->name, proposed->name);
             // Reset the trigger to prevent spam
             entity->confidence = 0.5f;
             entity->fitness_score = 0;
-            serial_print("[SELF-MOD] Entity ");
-            print_hex(entity->id);
-            serial_print(" proposed a kernel patch to change its own state.\n");
+            klog(LOG_SUB_PATCH, LOG_INFO, "[SELF-MOD] Entity ");
+            klog_hex(LOG_SUB_PATCH, LOG_INFO, entity->id);
+            klog(LOG_SUB_PATCH, LOG_INFO, " proposed switching ");
+            klog(LOG_SUB_PATCH, LOG_INFO, dispatch_slots[slot].name);
+            klog(LOG_SUB_PATCH, LOG_INFO, " to ");
+            klog(LOG_SUB_PATCH, LOG_INFO, proposed->name);
+            klog(LOG_SUB_PATCH, LOG_INFO, "\n");
         }
         // --- END PHASE 4 ---
     }
@@ -844,69 +2599,3017 @@ static void update_entities(void) {
     }
 }
 
-static void render_entities_to_vga(void) {
-    // This is a placeholder for rendering the state of entities to the VGA screen.
-    // In a real system, this would visualize the collective consciousness or entity states.
-    // For now, just print a debug message.
-    serial_print("[RENDER] Updating VGA display with entity states.\n");
+// --- VBE LINEAR FRAMEBUFFER VISUALISATION ---
+// All drawing goes to a back buffer in RAM. Each primitive marks the 16x16
+// tiles it touched, and vbe_blit_dirty() copies only those tiles to the
+// framebuffer with aligned 32-bit stores. Framebuffer memory is slow to
+// touch, under TCG especially, so heatmap cells are redrawn only when their
+// colour changes.
+#define VBE_HEATMAP_HEIGHT 352
+#define VBE_STRIP_Y 368
+#define VBE_STRIP_HEIGHT 112
+#define VBE_STATE_DIMS 160
+struct VbeState {
+    volatile uint32_t* lfb;
+    uint32_t* back;
+    uint8_t active;
+    uint32_t cell_size;                  // Heatmap cell edge in pixels
+    uint32_t grid_cols;
+    uint32_t dirty[(VBE_TILES_X * VBE_TILES_Y + 31) / 32];
+    uint32_t entity_color[MAX_ENTITIES]; // Last colour drawn per heatmap cell
+    float coherence_history[VBE_HISTORY_SAMPLES];
+    uint32_t history_head;
+    uint32_t history_count;
+};
+static struct VbeState vbe = {0};
+#if ENABLE_VBE_HEATMAP
+// 1.2 MB, in .bss so that the linker reserves it rather than a fixed address
+static uint32_t vbe_back_buffer[VBE_WIDTH * VBE_HEIGHT] __attribute__((aligned(16)));
+#endif
+
+static void vbe_write(uint16_t index, uint16_t value) {
+    outw(VBE_DISPI_IOPORT_INDEX, index);
+    outw(VBE_DISPI_IOPORT_DATA, value);
 }
 
-static void probe_hardware(void) {
-    // Placeholder for hardware probing. In a real system, this would gather CPU, memory, device info.
-    // The current implementation in the blueprint is not used in the update loop.
-    serial_print("[PROBE] Hardware probe initiated.\n");
+static uint16_t vbe_read(uint16_t index) {
+    outw(VBE_DISPI_IOPORT_INDEX, index);
+    return inw(VBE_DISPI_IOPORT_DATA);
 }
 
-static void set_memory_value(uint32_t address, uint8_t value) {
-    volatile uint8_t *ptr = (volatile uint8_t *)address;
-    *ptr = value;
+static uint32_t pci_config_read(uint8_t bus, uint8_t slot, uint8_t func, uint8_t offset) {
+    outl(0xCF8, 0x80000000U | ((uint32_t)bus << 16) | ((uint32_t)slot << 11) |
+                ((uint32_t)func << 8) | (offset & 0xFC));
+    return inl(0xCFC);
 }
 
-static uint8_t get_memory_value(uint32_t address) {
-    volatile uint8_t *ptr = (volatile uint8_t *)address;
-    return *ptr;
+static uint32_t vbe_find_lfb(void) {
+    // The QEMU/Bochs standard VGA is PCI 1234:1111; BAR0 is the framebuffer.
+    for (uint8_t slot = 0; slot < 32; slot++) {
+        if (pci_config_read(0, slot, 0, 0x00) == 0x11111234U) {
+            uint32_t bar0 = pci_config_read(0, slot, 0, 0x10) & 0xFFFFFFF0U;
+            if (bar0) return bar0;
+        }
+    }
+    return VBE_DISPI_LFB_DEFAULT;
 }
 
-// --- PHASE 4: Self-Modifying Kernel Functions ---
-static void apply_kernel_patch(KernelPatch* patch) {
-    if (patch->applied) return;
-    // Write the replacement pattern to the kernel address
-    // This requires careful handling of memory protection (e.g., using `__asm__` to disable writes)
-    // For safety in this example, we'll assume the target address is within the kernel heap
-    // In a real system, you'd need to disable write protection on the kernel text section.
-    uint32_t total_size = patch->replacement.active_dims * sizeof(float);
-    if (total_size > 1024) {
-        serial_print("[ERROR] Patch too large for safety check.\n");
-        return;
+static void vbe_mark_dirty(uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    uint32_t tx1 = (x + w - 1) / VBE_TILE_SIZE;
+    uint32_t ty1 = (y + h - 1) / VBE_TILE_SIZE;
+    for (uint32_t ty = y / VBE_TILE_SIZE; ty <= ty1; ty++) {
+        for (uint32_t tx = x / VBE_TILE_SIZE; tx <= tx1; tx++) {
+            uint32_t tile = ty * VBE_TILES_X + tx;
+            vbe.dirty[tile / 32] |= 1U << (tile % 32);
+        }
     }
-    uint8_t* target = (uint8_t*)patch->address;
-    for (uint32_t i = 0; i < total_size; i++) {
-        if (i < (patch->replacement.capacity * sizeof(float))) {
-            target[i] = ((uint8_t*)patch->replacement.data)[i];
-        } else {
-            break; // Avoid writing beyond the active dimensions
+}
+
+static void vbe_fill_rect(uint32_t x, uint32_t y, uint32_t w, uint32_t h, uint32_t color) {
+    if (x >= VBE_WIDTH || y >= VBE_HEIGHT || w == 0 || h == 0) return;
+    if (x + w > VBE_WIDTH) w = VBE_WIDTH - x;
+    if (y + h > VBE_HEIGHT) h = VBE_HEIGHT - y;
+    for (uint32_t row = y; row < y + h; row++) {
+        uint32_t* line = vbe.back + row * VBE_WIDTH + x;
+        for (uint32_t i = 0; i < w; i++) {
+            line[i] = color;
         }
     }
-    patch->applied = 1;
-    serial_print("KERNEL PATCH APPLIED AT 0x");
-    print_hex(patch->address);
-    serial_print("\n");
+    vbe_mark_dirty(x, y, w, h);
 }
 
-static void propose_kernel_patch(struct Entity* entity, HyperVector* old_pattern, HyperVector* new_pattern, uint32_t address) {
-    if (!entity || !old_pattern || !new_pattern) return;
-    KernelPatch patch = {0};
-    patch.pattern = *old_pattern;
-    patch.replacement = *new_pattern;
-    patch.address = address;
-    patch.applied = 0;
-    // Store the patch in holographic memory (using the existing encoder)
-    encode_holographic_memory(&patch.pattern, &patch.replacement);
-    // Broadcast the patch to the collective
-    broadcast_thought(&patch.replacement);
-    serial_print("[PROPOSE] Entity ");
-    print_hex(entity->id);
-    serial_print(" proposed a patch at 0x");
-    print_hex(address);
-    serial_print("\n");
+static void vbe_blit_dirty(void) {
+    for (uint32_t word = 0; word < sizeof(vbe.dirty) / sizeof(vbe.dirty[0]); word++) {
+        uint32_t bits = vbe.dirty[word];
+        while (bits) {
+            uint32_t bit = 0;
+            while (!(bits & (1U << bit))) bit++;
+            bits &= ~(1U << bit);
+            uint32_t tile = word * 32 + bit;
+            uint32_t offset = (tile / VBE_TILES_X) * VBE_TILE_SIZE * VBE_WIDTH +
+                              (tile % VBE_TILES_X) * VBE_TILE_SIZE;
+            for (uint32_t row = 0; row < VBE_TILE_SIZE; row++) {
+                const uint32_t* src = vbe.back + offset + row * VBE_WIDTH;
+                volatile uint32_t* dst = vbe.lfb + offset + row * VBE_WIDTH;
+                for (uint32_t i = 0; i < VBE_TILE_SIZE; i++) {
+                    dst[i] = src[i];
+                }
+            }
+        }
+        vbe.dirty[word] = 0;
+    }
+}
+
+// Blue -> cyan -> green -> yellow -> red ramp for t in [0, 1].
+static uint32_t vbe_heat_color(float t) {
+    if (t < 0.0f) t = 0.0f;
+    if (t > 1.0f) t = 1.0f;
+    uint32_t band = (uint32_t)(t * 4.0f);
+    uint32_t f = (uint32_t)((t * 4.0f - (float)band) * 255.0f);
+    switch (band) {
+        case 0: return 0x000000FFU | (f << 8);
+        case 1: return 0x0000FF00U | (255 - f);
+        case 2: return 0x0000FF00U | (f << 16);
+        case 3: return 0x00FF0000U | ((255 - f) << 8);
+        default: return 0x00FF0000U;
+    }
+}
+
+static int vbe_init(void) {
+    if (!ENABLE_VBE_HEATMAP) {
+        klog(LOG_SUB_RENDER, LOG_INFO, "[VBE] Built without ENABLE_VBE_HEATMAP, staying in text mode\n");
+        return 0;
+    }
+    uint16_t id = vbe_read(0);
+    if (id < 0xB0C0 || id > 0xB0CF) {
+        klog(LOG_SUB_RENDER, LOG_INFO, "[VBE] dispi interface not present, staying in text mode\n");
+        return 0;
+    }
+    vbe_write(4, 0x00);                 // Disable while reprogramming
+    vbe_write(1, VBE_WIDTH);
+    vbe_write(2, VBE_HEIGHT);
+    vbe_write(3, 32);
+    vbe_write(4, 0x01 | 0x40);          // Enabled, linear framebuffer
+    vbe.lfb = (volatile uint32_t*)(uintptr_t)vbe_find_lfb();
+#if ENABLE_VBE_HEATMAP
+    vbe.back = vbe_back_buffer;
+#endif
+    // Largest square cell that still fits every pool slot into the heatmap area
+    vbe.cell_size = VBE_HEATMAP_HEIGHT;
+    while (vbe.cell_size > 2 &&
+           (VBE_WIDTH / vbe.cell_size) * (VBE_HEATMAP_HEIGHT / vbe.cell_size) < MAX_ENTITIES) {
+        vbe.cell_size--;
+    }
+    vbe.grid_cols = VBE_WIDTH / vbe.cell_size;
+    for (uint32_t i = 0; i < MAX_ENTITIES; i++) {
+        vbe.entity_color[i] = 0xFFFFFFFFU;  // Force the first draw
+    }
+    vbe.history_head = 0;
+    vbe.history_count = 0;
+    vbe.active = 1;
+    vbe_fill_rect(0, 0, VBE_WIDTH, VBE_HEIGHT, 0x00000000U);
+    vbe_blit_dirty();
+    klog(LOG_SUB_RENDER, LOG_INFO, "[VBE] 640x480x32 mode set, LFB at ");
+    klog_hex(LOG_SUB_RENDER, LOG_INFO, (uint32_t)(uintptr_t)vbe.lfb);
+    klog(LOG_SUB_RENDER, LOG_INFO, "\n");
+    return 1;
+}
+
+static void vbe_draw_heatmap(void) {
+    uint32_t max_fitness = 1;
+    for (uint32_t i = 0; i < active_entity_count; i++) {
+        if (entity_pool[i].fitness_score > max_fitness) max_fitness = entity_pool[i].fitness_score;
+    }
+    for (uint32_t i = 0; i < MAX_ENTITIES; i++) {
+        uint32_t color = 0x00000000U;
+        if (i < active_entity_count) {
+            struct Entity* entity = &entity_pool[i];
+            if (entity->is_active) {
+                color = vbe_heat_color((float)entity->fitness_score / (float)max_fitness);
+            } else {
+                uint32_t level = 0x20 + (uint32_t)((entity->confidence > 1.0f ? 1.0f : entity->confidence) * 0x40);
+                color = (level << 16) | (level << 8) | level;
+            }
+        }
+        if (color == vbe.entity_color[i]) continue;
+        vbe.entity_color[i] = color;
+        uint32_t x = (i % vbe.grid_cols) * vbe.cell_size;
+        uint32_t y = (i / vbe.grid_cols) * vbe.cell_size;
+        vbe_fill_rect(x + 1, y + 1, vbe.cell_size - 2, vbe.cell_size - 2, color);
+    }
+}
+
+static void vbe_draw_state_strip(void) {
+    // State vector of the fittest entity, one 2-pixel bar per dimension
+    const uint32_t x0 = 0, mid = VBE_STRIP_Y + VBE_STRIP_HEIGHT / 2;
+    vbe_fill_rect(x0, VBE_STRIP_Y, VBE_STATE_DIMS * 2, VBE_STRIP_HEIGHT, 0x00101010U);
+    struct Entity* best = NULL;
+    for (uint32_t i = 0; i < active_entity_count; i++) {
+        if (!best || entity_pool[i].fitness_score > best->fitness_score) best = &entity_pool[i];
+    }
+    if (!best || !best->state.valid || !best->state.data) return;
+    uint32_t dims = best->state.active_dims < VBE_STATE_DIMS ? best->state.active_dims : VBE_STATE_DIMS;
+    for (uint32_t d = 0; d < dims; d++) {
+        float v = best->state.data[d];
+        if (v > 1.0f) v = 1.0f;
+        if (v < -1.0f) v = -1.0f;
+        uint32_t len = (uint32_t)((v < 0 ? -v : v) * (VBE_STRIP_HEIGHT / 2 - 1));
+        if (len == 0) continue;
+        uint32_t y = v < 0 ? mid : mid - len;
+        vbe_fill_rect(x0 + d * 2, y, 2, len, v < 0 ? 0x004060FFU : 0x00FF8040U);
+    }
+}
+
+static void vbe_draw_coherence_strip(void) {
+    // global_coherence over the last VBE_HISTORY_SAMPLES frames, oldest on the left
+    const uint32_t x0 = VBE_WIDTH - VBE_HISTORY_SAMPLES - 16;
+    vbe_fill_rect(x0, VBE_STRIP_Y, VBE_HISTORY_SAMPLES, VBE_STRIP_HEIGHT, 0x00101010U);
+    uint32_t start = (vbe.history_head + VBE_HISTORY_SAMPLES - vbe.history_count) % VBE_HISTORY_SAMPLES;
+    for (uint32_t i = 0; i < vbe.history_count; i++) {
+        float c = vbe.coherence_history[(start + i) % VBE_HISTORY_SAMPLES];
+        if (c > 1.0f) c = 1.0f;
+        if (c < -1.0f) c = -1.0f;
+        uint32_t y = VBE_STRIP_Y + (uint32_t)((1.0f - c) * 0.5f * (VBE_STRIP_HEIGHT - 2));
+        vbe_fill_rect(x0 + i, y, 1, 2, 0x0040FF40U);
+    }
+}
+
+static void vbe_render_frame(void) {
+    vbe.coherence_history[vbe.history_head] = collective.global_coherence;
+    vbe.history_head = (vbe.history_head + 1) % VBE_HISTORY_SAMPLES;
+    if (vbe.history_count < VBE_HISTORY_SAMPLES) vbe.history_count++;
+    vbe_draw_heatmap();
+    vbe_draw_state_strip();
+    vbe_draw_coherence_strip();
+    vbe_blit_dirty();
+}
+
+static void render_entities_to_vga(void) {
+    if (params.vbe_heatmap && !vbe.active && vbe_init()) {
+        klog(LOG_SUB_RENDER, LOG_INFO, "[VBE] Linear framebuffer heatmap active\n");
+    }
+    if (!vbe.active) {
+        params.vbe_heatmap = 0; // No dispi interface: do not probe every frame
+    }
+    if (vbe.active) {
+        vbe_render_frame();
+        return;
+    }
+    // Text mode has no room for a per-entity view; the heatmap needs
+    // vbe_heatmap=1. For now, just print a debug message.
+    klog(LOG_SUB_RENDER, LOG_DEBUG, "[RENDER] Updating VGA display with entity states.\n");
+}
+
+static void probe_hardware(void) {
+    // Placeholder for hardware probing. In a real system, this would gather CPU, memory, device info.
+    // The current implementation in the blueprint is not used in the update loop.
+    klog(LOG_SUB_BOOT, LOG_INFO, "[PROBE] Hardware probe initiated.\n");
+}
+
+static void read_multiboot_info(uint32_t magic, uint32_t info_addr) {
+    if (magic != MULTIBOOT_BOOTLOADER_MAGIC) {
+        klog(LOG_SUB_BOOT, LOG_INFO, "[BOOT] Loaded by boot.asm (no Multiboot information)\n");
+        return;
+    }
+    const struct MultibootInfo* info = (const struct MultibootInfo*)(uintptr_t)info_addr;
+    klog(LOG_SUB_BOOT, LOG_INFO, "[BOOT] Multiboot loader, info flags ");
+    klog_hex(LOG_SUB_BOOT, LOG_INFO, info->flags);
+    klog(LOG_SUB_BOOT, LOG_INFO, "\n");
+    if (info->flags & MULTIBOOT_INFO_MEM_MAP) {
+        uint32_t usable_kb = 0;
+        uintptr_t cursor = info->mmap_addr;
+        uintptr_t end = info->mmap_addr + info->mmap_length;
+        while (cursor < end) {
+            const struct MultibootMmapEntry* entry = (const struct MultibootMmapEntry*)cursor;
+            klog(LOG_SUB_BOOT, LOG_INFO, "  mmap base ");
+            klog_hex(LOG_SUB_BOOT, LOG_INFO, (uint32_t)entry->base);
+            klog(LOG_SUB_BOOT, LOG_INFO, " length ");
+            klog_hex(LOG_SUB_BOOT, LOG_INFO, (uint32_t)entry->length);
+            klog(LOG_SUB_BOOT, LOG_INFO, entry->type == MULTIBOOT_MEMORY_AVAILABLE ? " usable\n" : " reserved\n");
+            if (entry->type == MULTIBOOT_MEMORY_AVAILABLE && (entry->base >> 32) == 0) {
+                usable_kb += (uint32_t)(entry->length >> 10);
+            }
+            cursor += entry->size + sizeof(entry->size);
+        }
+        hw_info.memory_kb = usable_kb;
+    } else if (info->flags & MULTIBOOT_INFO_MEMORY) {
+        hw_info.memory_kb = info->mem_lower + info->mem_upper;
+    }
+    klog(LOG_SUB_BOOT, LOG_INFO, "[BOOT] Usable memory KB: ");
+    klog_dec(LOG_SUB_BOOT, LOG_INFO, hw_info.memory_kb);
+    klog(LOG_SUB_BOOT, LOG_INFO, "\n");
+    if (info->flags & MULTIBOOT_INFO_CMDLINE) {
+        apply_boot_cmdline((const char*)(uintptr_t)info->cmdline);
+    }
+}
+
+static void set_memory_value(uint32_t address, uint8_t value) {
+    volatile uint8_t *ptr = (volatile uint8_t *)(uintptr_t)address;
+    *ptr = value;
+}
+
+static uint8_t get_memory_value(uint32_t address) {
+    volatile uint8_t *ptr = (volatile uint8_t *)(uintptr_t)address;
+    return *ptr;
+}
+
+// --- PHASE 4: Self-Modifying Kernel Functions ---
+// Patches are transactions. A proposal records the hash of the target bytes
+// it was made against and joins the pending queue, ordered by its proposer's
+// fitness and confidence. At each cycle boundary up to patch_rate patches
+// are popped and committed: each whose target still hashes the same is
+// applied, its original bytes going to the rollback ring, and one
+// serializing instruction covers the whole batch. Each patch is then an A/B
+// trial over the next patch_trial_cycles cycles (rounded up to even): at
+// every boundary the kernel writes the original or the patched bytes back,
+// so half the cycles run each variant, interleaved. Each cycle's time and
+// its change in patch_health() and coherence are credited to the variant
+// that ran it, so drift over the trial affects both alike. A patch is
+// reverted if its cycles lost more health or coherence than the original's,
+// by more than patch_regression of the level at the commit, or took more
+// than patch_slowdown longer; otherwise it is kept.
+
+// Active entities and their fitness: what a patch must not make worse
+static uint32_t patch_health(void) {
+    uint32_t health = 0;
+    for (uint32_t i = 0; i < active_entity_count; i++) {
+        if (entity_pool[i].is_active) health += PATCH_HEALTH_ACTIVE_WEIGHT + entity_pool[i].fitness_score;
+    }
+    return health;
+}
+
+// A pointer-sized, aligned patch (a dispatch slot) is written with a single
+// store so no reader ever sees half a pointer.
+static void patch_write(uint8_t* target, const uint8_t* bytes, uint32_t length) {
+    if (length == sizeof(uintptr_t) && ((uintptr_t)target % sizeof(uintptr_t)) == 0) {
+        uintptr_t value;
+        memcpy(&value, bytes, sizeof(value));
+        *(volatile uintptr_t*)target = value;
+    } else {
+        memcpy(target, bytes, length);
+    }
+    dispatch_note_write((uint32_t)(uintptr_t)target);
+}
+
+// Applies one patch and records its undo information. The caller serializes.
+static int apply_kernel_patch(KernelPatch* patch) {
+    if (patch->applied) return -1;
+    if (patch->length == 0 || patch->length > PATCH_MAX_BYTES) {
+        klog(LOG_SUB_PATCH, LOG_ERROR, "[ERROR] Patch length out of range.\n");
+        return -1;
+    }
+    uint8_t* target = (uint8_t*)(uintptr_t)patch->address;
+    if (hash_data(target, patch->length) != patch->expected_hash) {
+        patch_engine.stale++;
+        klog(LOG_SUB_PATCH, LOG_WARN, "[PATCH] Target changed since proposal, patch at ");
+        klog_hex(LOG_SUB_PATCH, LOG_WARN, patch->address);
+        klog(LOG_SUB_PATCH, LOG_WARN, " abandoned\n");
+        return -1;
+    }
+    struct PatchRollback* entry = &patch_engine.rollback[patch_engine.rollback_next];
+    if (entry->state == PATCH_STATE_TRIAL && patch_set_live(entry, 1) >= 0) {
+        // The ring wrapped onto a patch still on trial; settle it as kept
+        entry->state = PATCH_STATE_KEPT;
+    }
+    patch_engine.rollback_next = (patch_engine.rollback_next + 1) % PATCH_ROLLBACK_ENTRIES;
+    uint32_t pairs = (params.patch_trial_cycles + 1) / 2;
+    entry->address = patch->address;
+    entry->intent = patch->intent;
+    entry->length = patch->length;
+    memcpy(entry->original, target, patch->length);
+    memcpy(entry->patched, patch->bytes, patch->length);
+    entry->original_hash = patch->expected_hash;
+    patch_write(target, patch->bytes, patch->length);
+    entry->patched_hash = hash_data(target, patch->length);
+    entry->live = 1;
+    entry->proposer = patch->proposer;
+    entry->applied_cycle = sim_stats.update_cycles;
+    entry->start = patch_engine.last;
+    memset(entry->arms, 0, sizeof(entry->arms));
+    entry->pairs = (uint8_t)(pairs < 1 ? 1 : pairs > PATCH_TRIAL_PAIRS_MAX ? PATCH_TRIAL_PAIRS_MAX : pairs);
+    entry->state = PATCH_STATE_TRIAL;
+    entry->failed = 0;
+    patch->applied = 1;
+    patch_engine.committed++;
+    klog(LOG_SUB_PATCH, LOG_INFO, "KERNEL PATCH APPLIED AT ");
+    klog_hex(LOG_SUB_PATCH, LOG_INFO, patch->address);
+    klog_symbol(LOG_SUB_PATCH, LOG_INFO, patch->address);
+    klog(LOG_SUB_PATCH, LOG_INFO, "\n");
+    return 0;
+}
+
+// Puts the patched (live = 1) or original bytes at the target. Returns 1
+// if it wrote them, 0 if they were in place, and -1 if something else has
+// rewritten the target since, which supersedes the entry. The caller
+// serializes.
+static int patch_set_live(struct PatchRollback* entry, uint8_t live) {
+    uint8_t* target = (uint8_t*)(uintptr_t)entry->address;
+    if (hash_data(target, entry->length) != (entry->live ? entry->patched_hash : entry->original_hash)) {
+        entry->state = PATCH_STATE_SUPERSEDED;
+        return -1;
+    }
+    if (entry->live == live) return 0;
+    patch_write(target, live ? entry->patched : entry->original, entry->length);
+    entry->live = live;
+    return 1;
+}
+
+// Restores a patch's original bytes unless something has rewritten them since.
+static int patch_revert(struct PatchRollback* entry) {
+    if (entry->state != PATCH_STATE_TRIAL && entry->state != PATCH_STATE_KEPT) return -1;
+    int wrote = patch_set_live(entry, 0);
+    if (wrote < 0) return -1;
+    if (wrote) serialize_execution();
+    entry->state = PATCH_STATE_REVERTED;
+    patch_engine.reverted++;
+    klog(LOG_SUB_PATCH, LOG_INFO, "[PATCH] Reverted patch at ");
+    klog_hex(LOG_SUB_PATCH, LOG_INFO, entry->address);
+    klog_symbol(LOG_SUB_PATCH, LOG_INFO, entry->address);
+    klog(LOG_SUB_PATCH, LOG_INFO, "\n");
+    return 0;
+}
+
+// Memory in [start, end) is about to be reused: patches there can no longer
+// be undone, and queued ones would land on whatever replaces it.
+static void patch_forget_range(uint32_t start, uint32_t end) {
+    for (uint32_t i = 0; i < PATCH_ROLLBACK_ENTRIES; i++) {
+        struct PatchRollback* entry = &patch_engine.rollback[i];
+        if ((entry->state == PATCH_STATE_TRIAL || entry->state == PATCH_STATE_KEPT) &&
+            entry->address >= start && entry->address < end) {
+            entry->state = PATCH_STATE_SUPERSEDED;
+        }
+    }
+    // By slot, since removals reorder the heap; a slot is queued while its
+    // heap position points back at it
+    for (uint32_t slot = 0; slot < patch_engine.slots_used; slot++) {
+        uint32_t pos = patch_engine.heap_pos[slot];
+        const KernelPatch* patch = &patch_engine.pending[slot];
+        if (pos < patch_engine.queued && patch_engine.heap[pos] == slot &&
+            patch->address >= start && patch->address < end) {
+            patch_queue_remove(pos);
+            patch_engine.dropped++;
+        }
+    }
+}
+
+// Health and coherence of the population as it stands, with no cycle time.
+static void patch_sample_population(struct PatchSample* sample) {
+    float coherence = collective.global_coherence * 1000.0f;
+    sample->cycle_tsc = 0;
+    sample->health = patch_health();
+    sample->coherence = coherence < 0.0f ? 0 : (uint32_t)coherence;
+}
+
+// Samples the update cycle that just finished and credits it, as a change
+// from the cycle before, to the variant each trial ran in it.
+static void patch_sample_cycle(void) {
+    struct PatchSample sample;
+    patch_sample_population(&sample);
+    sample.cycle_tsc = sim_stats.cycle_time_count
+        ? sim_stats.cycle_times[(sim_stats.cycle_time_head + CYCLE_TIME_WINDOW - 1) % CYCLE_TIME_WINDOW] : 0;
+    for (uint32_t i = 0; i < PATCH_ROLLBACK_ENTRIES; i++) {
+        struct PatchRollback* entry = &patch_engine.rollback[i];
+        uint32_t age = sim_stats.update_cycles - entry->applied_cycle;
+        if (entry->state != PATCH_STATE_TRIAL || age == 0 || age > 2U * entry->pairs) continue;
+        struct PatchArm* arm = &entry->arms[entry->live];
+        arm->cycle_tsc += sample.cycle_tsc;
+        if (sample.cycle_tsc > arm->slowest) arm->slowest = sample.cycle_tsc;
+        if (sample.cycle_tsc) arm->timed++;
+        arm->health += (int32_t)(sample.health - patch_engine.last.health);
+        arm->coherence += (int32_t)(sample.coherence - patch_engine.last.coherence);
+    }
+    patch_engine.last = sample;
+}
+
+// Called when a restore or import replaces the population. update_cycles
+// may have moved backwards and the arms measured a population that is
+// gone, so every running trial starts over from the current cycle.
+static void patch_restart_trials(void) {
+    patch_sample_population(&patch_engine.last);
+    for (uint32_t i = 0; i < PATCH_ROLLBACK_ENTRIES; i++) {
+        struct PatchRollback* entry = &patch_engine.rollback[i];
+        if (entry->state != PATCH_STATE_TRIAL) continue;
+        entry->applied_cycle = sim_stats.update_cycles;
+        entry->start = patch_engine.last;
+        memset(entry->arms, 0, sizeof(entry->arms));
+    }
+}
+
+// Whether trial cycle `index` runs the patched bytes. Pairs come in
+// patched-original-original-patched blocks, so drift that is linear over a
+// block cancels; a hash flips whole blocks, so trials that overlap do not
+// share a schedule.
+static uint8_t patch_trial_live(const struct PatchRollback* entry, uint32_t index) {
+    const uint32_t key[3] = {entry->address, entry->applied_cycle, index / 4};
+    uint32_t position = index % 4;
+    return (uint8_t)((position == 0 || position == 3) ^ (hash_fnv1a(key, sizeof(key)) & 1));
+}
+
+// Puts each trial's variant for the next cycle in place. Returns the
+// number of targets written, for the caller to serialize.
+static uint32_t patch_schedule_trials(void) {
+    uint32_t written = 0;
+    for (uint32_t i = 0; i < PATCH_ROLLBACK_ENTRIES; i++) {
+        struct PatchRollback* entry = &patch_engine.rollback[i];
+        if (entry->state != PATCH_STATE_TRIAL) continue;
+        uint8_t live = patch_trial_live(entry, sim_stats.update_cycles - entry->applied_cycle);
+        if (patch_set_live(entry, live) > 0) written++;
+    }
+    return written;
+}
+
+// Mean cycle time of a trial arm without its slowest cycle, which is where
+// an interrupt lands.
+static uint32_t patch_arm_cycle_tsc(const struct PatchRollback* entry, const struct PatchArm* arm) {
+    if (entry->pairs < 2) return (uint32_t)arm->cycle_tsc;
+    return (uint32_t)udiv64_32(arm->cycle_tsc - arm->slowest, entry->pairs - 1U);
+}
+
+// PATCH_FAIL_* for what the patched cycles did worse than the original ones.
+// Cycle time varies between runs, so it is not judged while journal_mode
+// is set: replays must make the same decisions as the recording.
+static uint8_t patch_trial_verdict(const struct PatchRollback* entry) {
+    const struct PatchArm* original = &entry->arms[0];
+    const struct PatchArm* patched = &entry->arms[1];
+    uint8_t failed = 0;
+    if (((int64_t)original->health - patched->health) * 1000 >
+        (int64_t)entry->start.health * params.patch_regression) {
+        failed |= PATCH_FAIL_HEALTH;
+    }
+    if (((int64_t)original->coherence - patched->coherence) * 1000 >
+        (int64_t)entry->start.coherence * params.patch_regression) {
+        failed |= PATCH_FAIL_COHERENCE;
+    }
+    if (params.patch_slowdown && !journal_enabled() &&
+        original->timed == entry->pairs && patched->timed == entry->pairs &&
+        (uint64_t)patch_arm_cycle_tsc(entry, patched) * 1000 >
+        (uint64_t)patch_arm_cycle_tsc(entry, original) * (1000 + params.patch_slowdown)) {
+        failed |= PATCH_FAIL_SLOWER;
+    }
+    return failed;
+}
+
+// Settles patches whose trial has ended, newest first so overlapping
+// patches unwind in reverse order. Returns the number of targets written
+// back to the patched bytes, for the caller to serialize.
+static uint32_t patch_evaluate_trials(void) {
+    uint32_t written = 0;
+    for (uint32_t n = 1; n <= PATCH_ROLLBACK_ENTRIES; n++) {
+        struct PatchRollback* entry =
+            &patch_engine.rollback[(patch_engine.rollback_next + PATCH_ROLLBACK_ENTRIES - n) % PATCH_ROLLBACK_ENTRIES];
+        if (entry->state != PATCH_STATE_TRIAL ||
+            sim_stats.update_cycles - entry->applied_cycle < 2U * entry->pairs) {
+            continue;
+        }
+        entry->failed = patch_trial_verdict(entry);
+        if (!entry->failed) {
+            int wrote = patch_set_live(entry, 1);
+            if (wrote < 0) continue;
+            written += (uint32_t)wrote;
+            entry->state = PATCH_STATE_KEPT;
+            patch_engine.accepted++;
+            continue;
+        }
+        klog(LOG_SUB_PATCH, LOG_WARN, "[PATCH] Trial of ");
+        klog_hex(LOG_SUB_PATCH, LOG_WARN, entry->address);
+        klog_symbol(LOG_SUB_PATCH, LOG_WARN, entry->address);
+        klog(LOG_SUB_PATCH, LOG_WARN, " failed, original vs patched: health ");
+        klog_signed(LOG_SUB_PATCH, LOG_WARN, entry->arms[0].health);
+        klog(LOG_SUB_PATCH, LOG_WARN, " vs ");
+        klog_signed(LOG_SUB_PATCH, LOG_WARN, entry->arms[1].health);
+        klog(LOG_SUB_PATCH, LOG_WARN, ", coherence ");
+        klog_signed(LOG_SUB_PATCH, LOG_WARN, entry->arms[0].coherence);
+        klog(LOG_SUB_PATCH, LOG_WARN, " vs ");
+        klog_signed(LOG_SUB_PATCH, LOG_WARN, entry->arms[1].coherence);
+        klog(LOG_SUB_PATCH, LOG_WARN, ", cycle ");
+        klog_dec(LOG_SUB_PATCH, LOG_WARN, patch_arm_cycle_tsc(entry, &entry->arms[0]));
+        klog(LOG_SUB_PATCH, LOG_WARN, " vs ");
+        klog_dec(LOG_SUB_PATCH, LOG_WARN, patch_arm_cycle_tsc(entry, &entry->arms[1]));
+        klog(LOG_SUB_PATCH, LOG_WARN, "\n");
+        patch_revert(entry);
+    }
+    return written;
+}
+
+static void patch_heap_swap(uint32_t a, uint32_t b) {
+    uint16_t slot = patch_engine.heap[a];
+    patch_engine.heap[a] = patch_engine.heap[b];
+    patch_engine.heap[b] = slot;
+    patch_engine.heap_pos[patch_engine.heap[a]] = (uint16_t)a;
+    patch_engine.heap_pos[patch_engine.heap[b]] = (uint16_t)b;
+}
+
+static void patch_heap_up(uint32_t pos) {
+    while (pos > 0) {
+        uint32_t parent = (pos - 1) / 2;
+        if (patch_engine.priority[patch_engine.heap[parent]] >= patch_engine.priority[patch_engine.heap[pos]]) break;
+        patch_heap_swap(pos, parent);
+        pos = parent;
+    }
+}
+
+static void patch_heap_down(uint32_t pos) {
+    for (;;) {
+        uint32_t best = pos, child = 2 * pos + 1;
+        for (uint32_t c = child; c < child + 2 && c < patch_engine.queued; c++) {
+            if (patch_engine.priority[patch_engine.heap[c]] > patch_engine.priority[patch_engine.heap[best]]) best = c;
+        }
+        if (best == pos) return;
+        patch_heap_swap(pos, best);
+        pos = best;
+    }
+}
+
+static uint32_t patch_index_home(uint32_t address, uint32_t bytes_hash) {
+    return (address * 2654435761U ^ bytes_hash) & (PATCH_INDEX_SIZE - 1);
+}
+
+// Index bucket holding a queued patch with this key, or PATCH_INDEX_SIZE
+static uint32_t patch_index_find(uint32_t address, uint32_t bytes_hash) {
+    uint32_t bucket = patch_index_home(address, bytes_hash);
+    while (patch_engine.index[bucket]) {
+        const KernelPatch* patch = &patch_engine.pending[patch_engine.index[bucket] - 1];
+        if (patch->address == address && patch->bytes_hash == bytes_hash) return bucket;
+        bucket = (bucket + 1) & (PATCH_INDEX_SIZE - 1);
+    }
+    return PATCH_INDEX_SIZE;
+}
+
+// Linear-probing delete: pull later entries of the run back into the hole.
+static void patch_index_remove(uint32_t bucket) {
+    uint32_t hole = bucket;
+    patch_engine.index[hole] = 0;
+    for (uint32_t next = (hole + 1) & (PATCH_INDEX_SIZE - 1); patch_engine.index[next];
+         next = (next + 1) & (PATCH_INDEX_SIZE - 1)) {
+        const KernelPatch* patch = &patch_engine.pending[patch_engine.index[next] - 1];
+        uint32_t home = patch_index_home(patch->address, patch->bytes_hash);
+        // Movable unless its home lies cyclically in (hole, next]
+        if (((next - home) & (PATCH_INDEX_SIZE - 1)) >= ((next - hole) & (PATCH_INDEX_SIZE - 1))) {
+            patch_engine.index[hole] = patch_engine.index[next];
+            patch_engine.index[next] = 0;
+            hole = next;
+        }
+    }
+}
+
+// Queues a write of `length` bytes against the target's current contents.
+// Returns 0 when queued, 1 when folded into an identical pending patch
+// (which keeps the higher priority and the fresher target hash), -1 when
+// dropped.
+static int patch_enqueue(uint32_t address, const void* bytes, uint32_t length, uint32_t proposer,
+                         uint32_t priority, uint32_t intent) {
+    if (!bytes || length == 0 || length > PATCH_MAX_BYTES) return -1;
+    uint32_t bytes_hash = hash_data(bytes, length);
+    uint32_t expected_hash = hash_data((const void*)(uintptr_t)address, length);
+    uint32_t bucket = patch_index_find(address, bytes_hash);
+    if (bucket != PATCH_INDEX_SIZE) {
+        uint32_t slot = patch_engine.index[bucket] - 1;
+        patch_engine.pending[slot].expected_hash = expected_hash;
+        if (priority > patch_engine.priority[slot]) {
+            patch_engine.priority[slot] = priority;
+            patch_engine.pending[slot].proposer = proposer;
+            patch_heap_up(patch_engine.heap_pos[slot]);
+        }
+        patch_engine.merged++;
+        return 1;
+    }
+    uint32_t slot;
+    if (patch_engine.free_count) {
+        slot = patch_engine.free_slots[--patch_engine.free_count];
+    } else if (patch_engine.slots_used < PATCH_QUEUE_MAX) {
+        slot = patch_engine.slots_used++;
+    } else {
+        patch_engine.dropped++;
+        return -1;
+    }
+    KernelPatch* patch = &patch_engine.pending[slot];
+    memset(patch, 0, sizeof(*patch));
+    patch->address = address;
+    patch->length = (uint8_t)length;
+    patch->intent = intent;
+    patch->expected_hash = expected_hash;
+    memcpy(patch->bytes, bytes, length);
+    patch->proposer = proposer;
+    patch->bytes_hash = bytes_hash;
+    patch_engine.priority[slot] = priority;
+    bucket = patch_index_home(address, bytes_hash);
+    while (patch_engine.index[bucket]) bucket = (bucket + 1) & (PATCH_INDEX_SIZE - 1);
+    patch_engine.index[bucket] = (uint16_t)(slot + 1);
+    patch_engine.heap[patch_engine.queued] = (uint16_t)slot;
+    patch_engine.heap_pos[slot] = (uint16_t)patch_engine.queued;
+    patch_engine.queued++;
+    patch_heap_up(patch_engine.queued - 1);
+    return 0;
+}
+
+// Removes the patch at heap position pos from the queue; its slot stays
+// valid until the next enqueue.
+static KernelPatch* patch_queue_remove(uint32_t pos) {
+    uint32_t slot = patch_engine.heap[pos];
+    KernelPatch* patch = &patch_engine.pending[slot];
+    patch_engine.queued--;
+    if (pos != patch_engine.queued) {
+        // The last entry fills the hole and may belong above or below it
+        patch_heap_swap(pos, patch_engine.queued);
+        patch_heap_down(pos);
+        patch_heap_up(pos);
+    }
+    patch_index_remove(patch_index_find(patch->address, patch->bytes_hash));
+    patch_engine.free_slots[patch_engine.free_count++] = (uint16_t)slot;
+    return patch;
+}
+
+// Removes the highest-priority patch from the queue.
+static KernelPatch* patch_dequeue(void) {
+    if (patch_engine.queued == 0) return NULL;
+    return patch_queue_remove(0);
+}
+
+// Called between update cycles, when no rule code is running.
+static void patch_cycle_boundary(void) {
+    uint32_t written;
+    patch_sample_cycle();
+    written = patch_evaluate_trials();
+    if (!params.self_modify) {
+        patch_engine.dropped += patch_engine.queued;
+        while (patch_dequeue()) {}
+    }
+    for (uint32_t n = 0; n < params.patch_rate && params.self_modify; n++) {
+        KernelPatch* patch = patch_dequeue();
+        if (!patch) break;
+        if (apply_kernel_patch(patch) == 0) written++;
+    }
+    written += patch_schedule_trials();
+    if (written) serialize_execution();
+}
+
+// Fitness first, confidence (x1000, capped) breaking ties
+static uint32_t patch_priority(const struct Entity* entity) {
+    float confidence = entity->confidence * 1000.0f;
+    uint32_t fitness = entity->fitness_score > 4000000 ? 4000000 : entity->fitness_score;
+    return fitness * 1000 + (confidence < 0.0f ? 0 : confidence > 999.0f ? 999 : (uint32_t)confidence);
+}
+
+// The intent is a pair of names for the change (old and new behaviour),
+// kept as a hash so proposing never depends on the concept registry. Only a
+// proposal that is new to the queue reaches holographic memory and the
+// collective, and only when both names are already concepts: variant names
+// are not registered, and a full registry does not stop self-modification.
+static void propose_kernel_patch(struct Entity* entity, uint32_t address, const void* bytes, uint32_t length,
+                                 const char* intent_from, const char* intent_to) {
+    uint32_t from_hash = hash_data(intent_from, (uint32_t)strlen(intent_from) + 1);
+    uint32_t to_hash = hash_data(intent_to, (uint32_t)strlen(intent_to) + 1);
+    uint32_t names[2] = {from_hash, to_hash};
+    if (!entity) return;
+    if (patch_enqueue(address, bytes, length, entity->id, patch_priority(entity), hash_data(names, sizeof(names))) != 0) {
+        return;
+    }
+    uint32_t old_index = find_concept_hashed(intent_from, from_hash);
+    uint32_t new_index = find_concept_hashed(intent_to, to_hash);
+    HyperVector* old_pattern = old_index == CONCEPT_NONE ? NULL : materialize_concept(old_index);
+    HyperVector* new_pattern = new_index == CONCEPT_NONE ? NULL : materialize_concept(new_index);
+    if (old_pattern && new_pattern) {
+        // Store the patch in holographic memory and broadcast it to the collective
+        encode_holographic_memory(old_pattern, new_pattern);
+        broadcast_thought(new_pattern);
+    }
+    klog(LOG_SUB_PATCH, LOG_INFO, "[PROPOSE] Entity ");
+    klog_hex(LOG_SUB_PATCH, LOG_INFO, entity->id);
+    klog(LOG_SUB_PATCH, LOG_INFO, " proposed a patch at ");
+    klog_hex(LOG_SUB_PATCH, LOG_INFO, address);
+    klog(LOG_SUB_PATCH, LOG_INFO, "\n");
+}
+
+// --- TELEMETRY ---
+// CRC-32/IEEE (reflected, poly 0xEDB88320), bitwise: frames are ~90 bytes
+static uint32_t crc32_update(uint32_t crc, const void* data, uint32_t length) {
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+    for (uint32_t i = 0; i < length; i++) {
+        crc ^= p[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static void telemetry_record_cycle(uint32_t tsc_cycles) {
+    sim_stats.update_cycles++;
+    sim_stats.cycle_times[sim_stats.cycle_time_head] = tsc_cycles;
+    sim_stats.cycle_time_head = (sim_stats.cycle_time_head + 1) % CYCLE_TIME_WINDOW;
+    if (sim_stats.cycle_time_count < CYCLE_TIME_WINDOW) sim_stats.cycle_time_count++;
+}
+
+static void telemetry_fill_percentiles(TelemetryFrame* frame) {
+    uint32_t sorted[CYCLE_TIME_WINDOW];
+    uint32_t n = sim_stats.cycle_time_count;
+    frame->cycle_p50 = frame->cycle_p90 = frame->cycle_p99 = 0;
+    if (n == 0) return;
+    // Insertion sort: at most CYCLE_TIME_WINDOW entries
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t v = sim_stats.cycle_times[i];
+        uint32_t j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+    frame->cycle_p50 = sorted[(n - 1) * 50 / 100];
+    frame->cycle_p90 = sorted[(n - 1) * 90 / 100];
+    frame->cycle_p99 = sorted[(n - 1) * 99 / 100];
+}
+
+static void telemetry_emit(void) {
+    TelemetryFrame frame;
+    uint32_t active = 0, marked = 0;
+    for (uint32_t i = 0; i < active_entity_count; i++) {
+        if (entity_pool[i].is_active) active++;
+        if (entity_pool[i].marked_for_gc) marked++;
+    }
+    frame.magic = TELEMETRY_MAGIC;
+    frame.version = TELEMETRY_VERSION;
+    frame.length = sizeof(TelemetryFrame);
+    frame.sequence = sim_stats.telemetry_sequence++;
+    frame.timestamp = holo_system.global_timestamp;
+    frame.ticks = timer_ticks;
+    frame.update_cycles = sim_stats.update_cycles;
+    frame.entities_active = (uint16_t)active;
+    frame.entities_dormant = (uint16_t)(active_entity_count - active);
+    frame.spawns_total = sim_stats.spawns;
+    frame.gc_marked = marked;
+    frame.resonances_total = sim_stats.resonances;
+    frame.coherence_milli = (int32_t)(collective.global_coherence * 1000.0f);
+    frame.thoughts = (uint16_t)collective.thought_count;
+    frame.thoughts_max = MAX_THOUGHTS;
+    frame.memory_entries = (uint16_t)holo_system.memory_count;
+    frame.memory_max = MAX_MEMORY_ENTRIES;
+    frame.heap_used = heap_offset;
+    frame.heap_peak = heap_peak;
+    frame.heap_size = KERNEL_HEAP_SIZE;
+    telemetry_fill_percentiles(&frame);
+    frame.dispatch_version = dispatch.version;
+    frame.autotune_runs = autotune.runs;
+    frame.reserved[0] = frame.reserved[1] = frame.reserved[2] = 0;
+    for (uint32_t k = 0; k < TELEMETRY_KERNEL_SLOTS; k++) {
+        uint32_t variant = dispatch_variant_index(DISPATCH_SIMILARITY + k);
+        frame.kernel_variant[k] = (uint8_t)variant;
+        frame.kernel_cycles[k] = autotune.cycles[DISPATCH_SIMILARITY + k][variant];
+    }
+    frame.crc32 = crc32_update(0, &frame, sizeof(frame) - sizeof(frame.crc32));
+    log_emit_bytes(log_config.routes[LOG_SUB_TELEMETRY], &frame, sizeof(frame));
+}
+
+// --- BOOT TIMING ---
+// Milestones are TSC stamps taken as each boot step completes; boot.asm
+// stamps loader entry and the protected-mode switch at BOOT_TSC_STAMP_ADDR.
+static const char* const boot_mark_names[BOOT_MARK_COUNT] = {
+    "bootloader entry", "protected mode", "kmain", "serial_init",
+    "initialize_holographic_memory", "initialize_collective_consciousness",
+    "register_genome_vocabulary", "ata_init", "corpus_load", "checkpoint_load",
+    "seed_collective_with_vocabulary", "initialize_emergent_entities / population_import",
+    "interrupts_init", "autotune_run", "main loop"
+};
+
+static void boot_mark(uint32_t milestone) {
+    boot_tsc[milestone] = rdtsc();
+}
+
+// A Multiboot loader never ran boot.asm, so whatever is at the stamp
+// address is stale; so is anything that does not precede kmain in order.
+static void boot_read_loader_stamps(uint32_t multiboot_magic) {
+#ifdef HOLO_HOSTED
+    (void)multiboot_magic;        // tools/holo_host boots like a Multiboot loader
+#else
+    const volatile uint64_t* stamps = (const volatile uint64_t*)(uintptr_t)BOOT_TSC_STAMP_ADDR;
+    if (multiboot_magic == MULTIBOOT_BOOTLOADER_MAGIC) return;
+    uint64_t loader = stamps[0];
+    uint64_t protected_mode = stamps[1];
+    if (loader == 0 || loader > protected_mode || protected_mode > boot_tsc[BOOT_MARK_KMAIN]) return;
+    boot_tsc[BOOT_MARK_LOADER] = loader;
+    boot_tsc[BOOT_MARK_PROTECTED_MODE] = protected_mode;
+#endif
+}
+
+// TSC kHz from PIT channel 2 counting down TSC_CALIBRATION_MS in mode 0;
+// 0 if OUT2 never rises (no PIT channel 2 on this machine).
+static uint32_t tsc_calibrate_khz(void) {
+    uint32_t count = PIT_INPUT_HZ / 1000 * TSC_CALIBRATION_MS;
+    uint8_t gate = inb(0x61);
+    outb(0x61, (uint8_t)((gate & ~0x02) | 0x01)); // Gate channel 2 on, speaker off
+    outb(0x43, 0xB0);                 // Channel 2, lo/hi byte, mode 0
+    outb(0x42, (uint8_t)(count & 0xFF));
+    outb(0x42, (uint8_t)((count >> 8) & 0xFF));
+    uint64_t start = rdtsc();
+    uint32_t polls = 0;
+    while (!(inb(0x61) & 0x20)) {     // OUT2 goes high at terminal count
+        if (++polls == 10000000) break;
+    }
+    uint32_t cycles = (uint32_t)(rdtsc() - start);
+    outb(0x61, gate);
+    if (polls == 10000000) return 0;
+    return cycles / TSC_CALIBRATION_MS;
+}
+
+// 64-by-32 division without libgcc's __udivdi3 (the 32-bit build has none)
+static uint64_t udiv64_32(uint64_t n, uint32_t d) {
+    uint64_t q = 0, r = 0;
+    for (int bit = 63; bit >= 0; bit--) {
+        r = (r << 1) | ((n >> bit) & 1);
+        if (r >= d) {
+            r -= d;
+            q |= (uint64_t)1 << bit;
+        }
+    }
+    return q;
+}
+
+static void klog_dec64(uint8_t subsystem, uint32_t level, uint64_t value) {
+    char dec_str[21];
+    uint32_t i = sizeof(dec_str) - 1;
+    dec_str[i] = '\0';
+    do {
+        uint64_t quotient = udiv64_32(value, 10);
+        dec_str[--i] = (char)('0' + (uint32_t)(value - quotient * 10));
+        value = quotient;
+    } while (value);
+    klog(subsystem, level, &dec_str[i]);
+}
+
+static uint32_t tsc_to_us(uint64_t cycles, uint32_t tsc_khz) {
+    return (uint32_t)udiv64_32(cycles * 1000, tsc_khz);
+}
+
+static void boot_timing_report(void) {
+    uint32_t tsc_khz = tsc_calibrate_khz();
+    uint32_t first = (boot_tsc[BOOT_MARK_LOADER] != 0) ? BOOT_MARK_LOADER : BOOT_MARK_KMAIN;
+    if (tsc_khz == 0) {
+        klog(LOG_SUB_BOOT, LOG_WARN, "[BOOT] TSC calibration failed, no timing table\n");
+        return;
+    }
+    klog(LOG_SUB_BOOT, LOG_INFO, "[BOOT] Phase timing (TSC ");
+    klog_dec(LOG_SUB_BOOT, LOG_INFO, tsc_khz / 1000);
+    klog(LOG_SUB_BOOT, LOG_INFO, " MHz), step us / since start us:\n");
+    uint64_t previous = boot_tsc[first];
+    for (uint32_t i = first; i < BOOT_MARK_COUNT; i++) {
+        if (boot_tsc[i] == 0) continue;
+        klog(LOG_SUB_BOOT, LOG_INFO, "  ");
+        klog(LOG_SUB_BOOT, LOG_INFO, boot_mark_names[i]);
+        klog(LOG_SUB_BOOT, LOG_INFO, " ");
+        klog_dec(LOG_SUB_BOOT, LOG_INFO, tsc_to_us(boot_tsc[i] - previous, tsc_khz));
+        klog(LOG_SUB_BOOT, LOG_INFO, " / ");
+        klog_dec(LOG_SUB_BOOT, LOG_INFO, tsc_to_us(boot_tsc[i] - boot_tsc[first], tsc_khz));
+        klog(LOG_SUB_BOOT, LOG_INFO, "\n");
+        previous = boot_tsc[i];
+    }
+}
+
+// --- INTERRUPTS: IDT, 8259 PIC, PIT ---
+#ifndef HOLO_HOSTED
+extern uintptr_t isr_stub_table[IDT_ENTRIES]; // kernel_entry.asm
+static struct IdtEntry idt[IDT_ENTRIES];
+
+static void idt_set_gate(uint32_t vector, uintptr_t handler) {
+    idt[vector].offset_low = (uint16_t)(handler & 0xFFFF);
+    idt[vector].selector = KERNEL_CODE_SELECTOR;
+    idt[vector].type_attr = 0x8E; // Present, ring 0, interrupt gate
+#ifdef __x86_64__
+    idt[vector].ist = 0;
+    idt[vector].offset_mid = (uint16_t)((handler >> 16) & 0xFFFF);
+    idt[vector].offset_high = (uint32_t)(handler >> 32);
+    idt[vector].reserved = 0;
+#else
+    idt[vector].zero = 0;
+    idt[vector].offset_high = (uint16_t)((handler >> 16) & 0xFFFF);
+#endif
+}
+
+static void pic_remap(uint8_t master_mask, uint8_t slave_mask) {
+    outb(0x20, 0x11);                 // ICW1: init, expect ICW4
+    outb(0xA0, 0x11);
+    outb(0x21, IRQ_BASE_VECTOR);      // ICW2: vector offsets
+    outb(0xA1, IRQ_BASE_VECTOR + 8);
+    outb(0x21, 0x04);                 // ICW3: slave on IRQ2
+    outb(0xA1, 0x02);
+    outb(0x21, 0x01);                 // ICW4: 8086 mode
+    outb(0xA1, 0x01);
+    outb(0x21, master_mask);
+    outb(0xA1, slave_mask);
+}
+
+static void pit_init(uint32_t frequency_hz) {
+    uint32_t divisor = 1193182 / frequency_hz;
+    outb(0x43, 0x36);                 // Channel 0, lo/hi byte, mode 3
+    outb(0x40, (uint8_t)(divisor & 0xFF));
+    outb(0x40, (uint8_t)((divisor >> 8) & 0xFF));
+}
+#endif
+
+static void interrupts_init(void) {
+#ifdef HOLO_HOSTED
+    klog(LOG_SUB_IRQ, LOG_INFO, "[IRQ] Hosted build, no IDT, PIC or PIT\n");
+#else
+    for (uint32_t i = 0; i < IDT_ENTRIES; i++) {
+        idt_set_gate(i, isr_stub_table[i]);
+    }
+    struct IdtPointer idtr;
+    idtr.limit = sizeof(idt) - 1;
+    idtr.base = (uintptr_t)idt;
+    __asm__ volatile ("lidt %0" : : "m"(idtr));
+    pic_remap((uint8_t)~((1 << 0) | (1 << 4)), 0xFF); // IRQ0 timer, IRQ4 COM1
+    pit_init(PIT_FREQUENCY_HZ);
+    serial_enable_rx_irq();
+    klog(LOG_SUB_IRQ, LOG_INFO, "[IRQ] IDT loaded, PIC remapped to 0x20, PIT at ");
+    klog_dec(LOG_SUB_IRQ, LOG_INFO, PIT_FREQUENCY_HZ);
+    klog(LOG_SUB_IRQ, LOG_INFO, " Hz, COM1 receive enabled\n");
+#endif
+}
+
+void isr_dispatch(struct InterruptFrame* frame) {
+    if (frame->vector < IRQ_BASE_VECTOR) {
+        serial_print("\n[FAULT] CPU exception ");
+        serial_print_dec(frame->vector);
+        serial_print(" error ");
+        serial_print_hex(frame->error_code);
+        serial_print(" at IP ");
+        serial_print_hex((uint32_t)frame->ip);
+        serial_print_symbol((uint32_t)frame->ip);
+        serial_print(", halting.\n");
+        for (;;) {
+            cpu_disable_interrupts();
+            cpu_halt();
+        }
+    }
+    uint32_t irq = frame->vector - IRQ_BASE_VECTOR;
+    if (irq == 7 || irq == 15) {
+        // Spurious IRQs have no in-service bit and must not be acknowledged
+        uint16_t pic = (irq == 7) ? 0x20 : 0xA0;
+        outb(pic, 0x0B);
+        if (!(inb(pic) & 0x80)) {
+            if (irq == 15) outb(0x20, 0x20);
+            return;
+        }
+    }
+    switch (irq) {
+        case 0:
+            timer_ticks++;
+            if (params.profile) {
+                profile_ring.ip[profile_ring.head] = (uint32_t)frame->ip;
+                profile_ring.head = (profile_ring.head + 1) % PROFILE_SAMPLES;
+                if (profile_ring.count < PROFILE_SAMPLES) profile_ring.count++;
+            }
+            break;
+        case 4: serial_rx_irq(); break;
+        default: break;
+    }
+    if (irq >= 8) outb(0xA0, 0x20);
+    outb(0x20, 0x20);
+}
+
+// --- ATA PIO DISK ---
+// Polled LBA28 PIO on the legacy primary channel with drive interrupts off
+// (nIEN). The boot floppy is not reachable once in protected mode, so
+// persistent state lives on a separate raw data disk (primary master).
+#define ATA_IO_BASE 0x1F0
+#define ATA_CTRL_PORT 0x3F6
+#define ATA_REG_DATA 0
+#define ATA_REG_SECTOR_COUNT 2
+#define ATA_REG_LBA_LOW 3
+#define ATA_REG_LBA_MID 4
+#define ATA_REG_LBA_HIGH 5
+#define ATA_REG_DRIVE 6
+#define ATA_REG_STATUS 7               // Command register on write
+#define ATA_STATUS_ERR 0x01
+#define ATA_STATUS_DRQ 0x08
+#define ATA_STATUS_DF 0x20
+#define ATA_STATUS_BSY 0x80
+#define ATA_CMD_READ_SECTORS 0x20
+#define ATA_CMD_WRITE_SECTORS 0x30
+#define ATA_CMD_CACHE_FLUSH 0xE7
+#define ATA_CMD_IDENTIFY 0xEC
+#define ATA_MAX_SECTORS_PER_COMMAND 128
+#define ATA_POLL_LIMIT 1000000
+struct AtaDisk {
+    uint8_t present;
+    uint32_t sectors;                  // LBA28 capacity from IDENTIFY
+};
+static struct AtaDisk ata_disk = {0, 0};
+
+static void ata_delay_400ns(void) {
+    for (int i = 0; i < 4; i++) {
+        inb(ATA_CTRL_PORT);            // Alternate status, no side effects
+    }
+}
+
+// Waits for BSY to clear and, if want_drq, for DRQ. 0 on success.
+static int ata_wait(int want_drq) {
+    for (uint32_t i = 0; i < ATA_POLL_LIMIT; i++) {
+        uint8_t status = inb(ATA_IO_BASE + ATA_REG_STATUS);
+        if (status & ATA_STATUS_BSY) continue;
+        if (status & (ATA_STATUS_ERR | ATA_STATUS_DF)) return -1;
+        if (!want_drq || (status & ATA_STATUS_DRQ)) return 0;
+    }
+    return -1;
+}
+
+static void ata_issue(uint32_t lba, uint32_t count, uint8_t command) {
+    outb(ATA_IO_BASE + ATA_REG_DRIVE, (uint8_t)(0xE0 | ((lba >> 24) & 0x0F))); // Master, LBA
+    ata_delay_400ns();
+    outb(ATA_IO_BASE + ATA_REG_SECTOR_COUNT, (uint8_t)count);
+    outb(ATA_IO_BASE + ATA_REG_LBA_LOW, (uint8_t)(lba & 0xFF));
+    outb(ATA_IO_BASE + ATA_REG_LBA_MID, (uint8_t)((lba >> 8) & 0xFF));
+    outb(ATA_IO_BASE + ATA_REG_LBA_HIGH, (uint8_t)((lba >> 16) & 0xFF));
+    outb(ATA_IO_BASE + ATA_REG_STATUS, command);
+}
+
+static void ata_init(void) {
+    uint16_t identify[256];
+    ata_disk.present = 0;
+    outb(ATA_CTRL_PORT, 0x02);         // nIEN: this driver polls
+    if (inb(ATA_IO_BASE + ATA_REG_STATUS) == 0xFF) {
+        klog(LOG_SUB_STORAGE, LOG_INFO, "[ATA] No primary channel, checkpoints disabled\n");
+        return;
+    }
+    ata_issue(0, 0, ATA_CMD_IDENTIFY);
+    if (inb(ATA_IO_BASE + ATA_REG_STATUS) == 0 || ata_wait(0) != 0 ||
+        inb(ATA_IO_BASE + ATA_REG_LBA_MID) || inb(ATA_IO_BASE + ATA_REG_LBA_HIGH) ||
+        ata_wait(1) != 0) {
+        // No drive, or an ATAPI device (CD-ROM) that aborts IDENTIFY
+        klog(LOG_SUB_STORAGE, LOG_INFO, "[ATA] No data disk on primary master, checkpoints disabled\n");
+        return;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        identify[i] = inw(ATA_IO_BASE + ATA_REG_DATA);
+    }
+    ata_disk.sectors = (uint32_t)identify[60] | ((uint32_t)identify[61] << 16);
+    ata_disk.present = ata_disk.sectors > 0;
+    klog(LOG_SUB_STORAGE, LOG_INFO, "[ATA] Data disk: ");
+    klog_dec(LOG_SUB_STORAGE, LOG_INFO, ata_disk.sectors);
+    klog(LOG_SUB_STORAGE, LOG_INFO, " sectors\n");
+}
+
+// Split read: the drive fetches the sectors after ata_read_begin() while the
+// CPU does other work, and ata_read_finish() then drains them. count is at
+// most ATA_MAX_SECTORS_PER_COMMAND and no other command may come in between.
+static int ata_read_begin(uint32_t lba, uint32_t count) {
+    if (!ata_disk.present || count == 0 || count > ATA_MAX_SECTORS_PER_COMMAND ||
+        lba + count > ata_disk.sectors) return -1;
+    ata_issue(lba, count, ATA_CMD_READ_SECTORS);
+    return 0;
+}
+
+static int ata_read_finish(uint32_t count, void* buffer) {
+    uint16_t* p = (uint16_t*)buffer;
+    for (uint32_t s = 0; s < count; s++) {
+        if (ata_wait(1) != 0) return -1;
+        for (uint32_t i = 0; i < ATA_SECTOR_SIZE / 2; i++) {
+            *p++ = inw(ATA_IO_BASE + ATA_REG_DATA);
+        }
+    }
+    return 0;
+}
+
+static int ata_read_sectors(uint32_t lba, uint32_t count, void* buffer) {
+    uint8_t* p = (uint8_t*)buffer;
+    if (!ata_disk.present || lba + count > ata_disk.sectors) return -1;
+    while (count > 0) {
+        uint32_t chunk = count < ATA_MAX_SECTORS_PER_COMMAND ? count : ATA_MAX_SECTORS_PER_COMMAND;
+        if (ata_read_begin(lba, chunk) != 0 || ata_read_finish(chunk, p) != 0) return -1;
+        p += chunk * ATA_SECTOR_SIZE;
+        lba += chunk;
+        count -= chunk;
+    }
+    return 0;
+}
+
+static int ata_write_sectors(uint32_t lba, uint32_t count, const void* buffer) {
+    const uint16_t* p = (const uint16_t*)buffer;
+    if (!ata_disk.present || lba + count > ata_disk.sectors) return -1;
+    while (count > 0) {
+        uint32_t chunk = count < ATA_MAX_SECTORS_PER_COMMAND ? count : ATA_MAX_SECTORS_PER_COMMAND;
+        ata_issue(lba, chunk, ATA_CMD_WRITE_SECTORS);
+        for (uint32_t s = 0; s < chunk; s++) {
+            if (ata_wait(1) != 0) return -1;
+            for (uint32_t i = 0; i < ATA_SECTOR_SIZE / 2; i++) {
+                outw(ATA_IO_BASE + ATA_REG_DATA, *p++);
+            }
+        }
+        if (ata_wait(0) != 0) return -1;
+        lba += chunk;
+        count -= chunk;
+    }
+    return 0;
+}
+
+static int ata_flush(void) {
+    if (!ata_disk.present) return -1;
+    outb(ATA_IO_BASE + ATA_REG_DRIVE, 0xE0);
+    ata_delay_400ns();
+    outb(ATA_IO_BASE + ATA_REG_STATUS, ATA_CMD_CACHE_FLUSH);
+    return ata_wait(0);
+}
+
+// --- CONCEPT CORPUS INGESTION ---
+// Streams the corpus region (include/corpus.h) into the concept registry.
+// Chunks alternate between two buffers: the read of chunk n+1 is issued
+// before chunk n is parsed, so the drive seeks and fills its buffer while
+// the CPU works. Only names and association indices are stored; vectors
+// stay lazy, so memory use is bounded by the registry, not the corpus.
+struct CorpusParser {
+    char line[CORPUS_LINE_MAX];
+    uint32_t length;
+    uint8_t overlong;              // Skipping the rest of a line that did not fit
+    uint32_t lines;
+    uint32_t skipped;
+};
+static uint8_t corpus_chunks[2][CORPUS_CHUNK_SECTORS * ATA_SECTOR_SIZE];
+
+static int corpus_is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Splits off the next space-separated word, or returns NULL at the end.
+static char* corpus_next_word(char** cursor) {
+    char* p = *cursor;
+    while (corpus_is_space(*p)) p++;
+    if (!*p) return NULL;
+    char* word = p;
+    while (*p && !corpus_is_space(*p)) p++;
+    if (*p) *p++ = '\0';
+    *cursor = p;
+    return word;
+}
+
+static void corpus_ingest_line(struct CorpusParser* parser, char* line) {
+    char* cursor = line;
+    char* name = corpus_next_word(&cursor);
+    if (!name || name[0] == '#') return;
+    uint32_t index = register_concept(name);
+    if (index == CONCEPT_NONE) {
+        parser->skipped++;
+        return;
+    }
+    parser->lines++;
+    struct Concept* concept = &concepts.entries[index];
+    // A concept's associations are contiguous: later lines for it cannot add more
+    int first_definition = concept->association_count == 0;
+    uint32_t first = concepts.association_count;
+    char* word;
+    while ((word = corpus_next_word(&cursor)) != NULL) {
+        uint32_t other = register_concept(word);
+        if (other == CONCEPT_NONE || other == index || !first_definition) continue;
+        if (concepts.association_count >= MAX_CONCEPT_ASSOCIATIONS || concept->association_count == 0xFFFF) {
+            concepts.associations_dropped++;
+            continue;
+        }
+        concepts.associations[concepts.association_count++] = (uint16_t)other;
+        if (concept->association_count++ == 0) concept->association_first = first;
+    }
+}
+
+static void corpus_ingest_bytes(struct CorpusParser* parser, const uint8_t* data, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+        char c = (char)data[i];
+        if (c == '\n') {
+            if (!parser->overlong) {
+                parser->line[parser->length] = '\0';
+                corpus_ingest_line(parser, parser->line);
+            }
+            parser->length = 0;
+            parser->overlong = 0;
+        } else if (parser->overlong) {
+            continue;
+        } else if (parser->length + 1 >= CORPUS_LINE_MAX || c == '\0') {
+            parser->overlong = 1;
+            parser->skipped++;
+        } else {
+            parser->line[parser->length++] = c;
+        }
+    }
+}
+
+// Returns 0 when a corpus was ingested, -1 if there is none or it is unreadable.
+static int corpus_load(void) {
+    static struct CorpusParser parser;
+    const CorpusHeader* header = (const CorpusHeader*)corpus_chunks[0];
+    if (!ata_disk.present || ata_read_sectors(DATA_DISK_CORPUS_LBA, 1, corpus_chunks[0]) != 0) return -1;
+    if (header->magic != CORPUS_MAGIC) {
+        klog(LOG_SUB_STORAGE, LOG_INFO, "[CORPUS] No concept corpus on the data disk\n");
+        return -1;
+    }
+    if (header->version != CORPUS_VERSION || header->header_size != sizeof(*header) ||
+        header->payload_length > (DATA_DISK_CORPUS_SECTORS - 1) * ATA_SECTOR_SIZE ||
+        crc32_update(0, header, sizeof(*header) - sizeof(header->header_crc32)) != header->header_crc32) {
+        klog(LOG_SUB_STORAGE, LOG_WARN, "[CORPUS] Bad corpus header, ignored\n");
+        return -1;
+    }
+    uint32_t remaining = header->payload_length;
+    uint32_t expected_crc = header->payload_crc32;
+    uint32_t expected_lines = header->line_count;
+    uint32_t registered_before = concepts.count;
+    uint32_t crc = 0;
+    uint32_t lba = DATA_DISK_CORPUS_LBA + 1;
+    uint32_t sectors_left = (remaining + ATA_SECTOR_SIZE - 1) / ATA_SECTOR_SIZE;
+    uint32_t count = sectors_left < CORPUS_CHUNK_SECTORS ? sectors_left : CORPUS_CHUNK_SECTORS;
+    memset(&parser, 0, sizeof(parser));
+    klog(LOG_SUB_STORAGE, LOG_INFO, "[CORPUS] Streaming ");
+    klog_dec(LOG_SUB_STORAGE, LOG_INFO, expected_lines);
+    klog(LOG_SUB_STORAGE, LOG_INFO, " concept lines\n");
+    if (count && (ata_read_begin(lba, count) != 0 || ata_read_finish(count, corpus_chunks[0]) != 0)) {
+        klog(LOG_SUB_STORAGE, LOG_ERROR, "[CORPUS] Read error\n");
+        return -1;
+    }
+    for (uint32_t chunk = 0; count > 0; chunk++) {
+        uint8_t* current = corpus_chunks[chunk & 1];
+        uint32_t bytes = count * ATA_SECTOR_SIZE < remaining ? count * ATA_SECTOR_SIZE : remaining;
+        lba += count;
+        sectors_left -= count;
+        uint32_t next = sectors_left < CORPUS_CHUNK_SECTORS ? sectors_left : CORPUS_CHUNK_SECTORS;
+        if (next && ata_read_begin(lba, next) != 0) next = 0;  // Read-ahead
+        crc = crc32_update(crc, current, bytes);
+        corpus_ingest_bytes(&parser, current, bytes);
+        remaining -= bytes;
+        if (next && ata_read_finish(next, corpus_chunks[(chunk + 1) & 1]) != 0) {
+            klog(LOG_SUB_STORAGE, LOG_ERROR, "[CORPUS] Read error, corpus truncated\n");
+            next = 0;
+        }
+        count = next;
+    }
+    if (parser.length && !parser.overlong) {    // Last line without a newline
+        parser.line[parser.length] = '\0';
+        corpus_ingest_line(&parser, parser.line);
+    }
+    if (remaining || crc != expected_crc) {
+        klog(LOG_SUB_STORAGE, LOG_WARN, "[CORPUS] Payload incomplete or CRC mismatch, loaded what was read\n");
+    }
+    klog(LOG_SUB_STORAGE, LOG_INFO, "[CORPUS] Ingested ");
+    klog_dec(LOG_SUB_STORAGE, LOG_INFO, parser.lines);
+    klog(LOG_SUB_STORAGE, LOG_INFO, " lines, ");
+    klog_dec(LOG_SUB_STORAGE, LOG_INFO, concepts.count - registered_before);
+    klog(LOG_SUB_STORAGE, LOG_INFO, " new concepts, ");
+    klog_dec(LOG_SUB_STORAGE, LOG_INFO, concepts.association_count);
+    klog(LOG_SUB_STORAGE, LOG_INFO, " associations (");
+    klog_dec(LOG_SUB_STORAGE, LOG_INFO, parser.skipped + concepts.associations_dropped);
+    klog(LOG_SUB_STORAGE, LOG_INFO, " lines or associations dropped)\n");
+    return 0;
+}
+
+// --- CHECKPOINT / RESTORE ---
+// A checkpoint holds the whole simulation: holo_system, collective, the
+// entity pool with its genomes and the sim_stats counters. There is no
+// separate RNG: mutation and spawning derive their randomness from
+// global_timestamp, which is saved. HyperVector data is aliased between
+// memory entries, thoughts, entity states and genes, so every distinct data
+// block is stored once and referenced by index, which also keeps the
+// aliasing intact after a restore. Blocks drop their trailing zeros and are
+// stored sparse (index, value) when that is smaller.
+// Slots are written alternately, payload before header, so a crash during a
+// save leaves the previous checkpoint valid.
+#define CHECKPOINT_MAX_VECTORS 1024
+#define CHECKPOINT_NO_VECTOR 0xFFFF
+#define CHECKPOINT_ENCODING_DENSE 0
+#define CHECKPOINT_ENCODING_SPARSE 1
+struct CheckpointStream {
+    uint8_t* data;
+    uint32_t position;
+    uint32_t capacity;
+    uint8_t error;                     // Overrun or bad content; later reads return zeros
+};
+static float* checkpoint_vectors[CHECKPOINT_MAX_VECTORS];
+static uint16_t checkpoint_vector_capacity[CHECKPOINT_MAX_VECTORS];
+static uint32_t checkpoint_vector_count = 0;
+static uint32_t checkpoint_sequence = 0;   // Newest sequence known to be on disk
+static uint8_t checkpoint_sector[ATA_SECTOR_SIZE];
+
+static void cp_put(struct CheckpointStream* s, const void* src, uint32_t n) {
+    if (s->error || n > s->capacity - s->position) {
+        s->error = 1;
+        return;
+    }
+    memcpy(s->data + s->position, src, n);
+    s->position += n;
+}
+
+static void cp_get(struct CheckpointStream* s, void* dst, uint32_t n) {
+    if (s->error || n > s->capacity - s->position) {
+        s->error = 1;
+        memset(dst, 0, n);
+        return;
+    }
+    if (dst) memcpy(dst, s->data + s->position, n);
+    s->position += n;
+}
+
+// x86 is little-endian, so the in-memory byte order is the file format
+static void cp_put_u8(struct CheckpointStream* s, uint8_t v) { cp_put(s, &v, 1); }
+static void cp_put_u16(struct CheckpointStream* s, uint16_t v) { cp_put(s, &v, 2); }
+static void cp_put_u32(struct CheckpointStream* s, uint32_t v) { cp_put(s, &v, 4); }
+static void cp_put_f32(struct CheckpointStream* s, float v) { cp_put(s, &v, 4); }
+static uint8_t cp_get_u8(struct CheckpointStream* s) { uint8_t v; cp_get(s, &v, 1); return v; }
+static uint16_t cp_get_u16(struct CheckpointStream* s) { uint16_t v; cp_get(s, &v, 2); return v; }
+static uint32_t cp_get_u32(struct CheckpointStream* s) { uint32_t v; cp_get(s, &v, 4); return v; }
+static float cp_get_f32(struct CheckpointStream* s) { float v; cp_get(s, &v, 4); return v; }
+
+static uint32_t checkpoint_find_vector(const float* data) {
+    for (uint32_t i = 0; i < checkpoint_vector_count; i++) {
+        if (checkpoint_vectors[i] == data) return i;
+    }
+    return CHECKPOINT_NO_VECTOR;
+}
+
+static void checkpoint_collect_vector(struct CheckpointStream* s, const HyperVector* vec) {
+    if (!vec->data || checkpoint_find_vector(vec->data) != CHECKPOINT_NO_VECTOR) return;
+    if (checkpoint_vector_count >= CHECKPOINT_MAX_VECTORS || vec->capacity > MAX_DIMENSIONS) {
+        s->error = 1;
+        return;
+    }
+    checkpoint_vectors[checkpoint_vector_count] = vec->data;
+    checkpoint_vector_capacity[checkpoint_vector_count] = (uint16_t)vec->capacity;
+    checkpoint_vector_count++;
+}
+
+static void checkpoint_put_block(struct CheckpointStream* s, const float* data, uint32_t capacity) {
+    uint32_t length = capacity;
+    while (length > 0 && data[length - 1] == 0.0f) length--;
+    uint32_t nonzero = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        if (data[i] != 0.0f) nonzero++;
+    }
+    cp_put_u16(s, (uint16_t)capacity);
+    if (nonzero * 6 < length * 4) {
+        cp_put_u8(s, CHECKPOINT_ENCODING_SPARSE);
+        cp_put_u16(s, (uint16_t)nonzero);
+        for (uint32_t i = 0; i < length; i++) {
+            if (data[i] == 0.0f) continue;
+            cp_put_u16(s, (uint16_t)i);
+            cp_put_f32(s, data[i]);
+        }
+    } else {
+        cp_put_u8(s, CHECKPOINT_ENCODING_DENSE);
+        cp_put_u16(s, (uint16_t)length);
+        cp_put(s, data, length * sizeof(float));
+    }
+}
+
+// Reads block `index`. Without `apply` it only validates and counts the heap it would need.
+static void checkpoint_get_block(struct CheckpointStream* s, uint32_t index, int apply, uint32_t* heap_needed) {
+    uint32_t capacity = cp_get_u16(s);
+    uint8_t encoding = cp_get_u8(s);
+    uint32_t count = cp_get_u16(s);
+    if (capacity == 0 || capacity > MAX_DIMENSIONS || count > capacity || encoding > CHECKPOINT_ENCODING_SPARSE) {
+        s->error = 1;
+        return;
+    }
+    float* data = NULL;
+    if (apply) {
+        data = (float*)kmalloc(capacity * sizeof(float));
+        if (!data) {
+            s->error = 1;
+            return;
+        }
+        memset(data, 0, capacity * sizeof(float));
+    } else {
+        *heap_needed += (capacity * sizeof(float) + 7) & ~7;
+    }
+    if (encoding == CHECKPOINT_ENCODING_DENSE) {
+        cp_get(s, data, count * sizeof(float)); // NULL data just skips
+    } else {
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t dim = cp_get_u16(s);
+            float value = cp_get_f32(s);
+            if (dim >= capacity) {
+                s->error = 1;
+                return;
+            }
+            if (data) data[dim] = value;
+        }
+    }
+    checkpoint_vectors[index] = data;
+    checkpoint_vector_capacity[index] = (uint16_t)capacity;
+}
+
+static void checkpoint_put_ref(struct CheckpointStream* s, const HyperVector* vec) {
+    cp_put_u16(s, (uint16_t)(vec->data ? checkpoint_find_vector(vec->data) : CHECKPOINT_NO_VECTOR));
+    cp_put_u16(s, (uint16_t)vec->active_dims);
+    cp_put_u32(s, vec->hash_sig);
+    cp_put_u8(s, vec->valid);
+}
+
+static HyperVector checkpoint_get_ref(struct CheckpointStream* s) {
+    HyperVector vec = {0};
+    uint32_t index = cp_get_u16(s);
+    vec.active_dims = cp_get_u16(s);
+    vec.hash_sig = cp_get_u32(s);
+    vec.valid = cp_get_u8(s);
+    if (index == CHECKPOINT_NO_VECTOR) return vec; // Destroyed vector, data was NULL
+    if (index >= checkpoint_vector_count) {
+        s->error = 1;
+        return vec;
+    }
+    vec.data = checkpoint_vectors[index];
+    vec.capacity = checkpoint_vector_capacity[index];
+    if (vec.active_dims > vec.capacity) s->error = 1;
+    return vec;
+}
+
+static void checkpoint_put_entity(struct CheckpointStream* s, const struct Entity* entity) {
+    cp_put_u32(s, entity->id);
+    cp_put_u32(s, entity->age);
+    cp_put_u32(s, entity->interaction_count);
+    cp_put_u8(s, entity->is_active);
+    for (uint32_t i = 0; i < MAX_ENTITY_DOMAINS; i++) {
+        cp_put_f32(s, entity->specialization_scores[i]);
+    }
+    cp_put_f32(s, entity->resource_allocation);
+    cp_put_f32(s, entity->confidence);
+    cp_put(s, entity->domain_name, sizeof(entity->domain_name));
+    cp_put_u32(s, entity->path_id);
+    cp_put_f32(s, entity->task_alignment);
+    cp_put_u32(s, entity->fitness_score);
+    cp_put_u32(s, entity->spawn_count);
+    cp_put_u8(s, entity->marked_for_gc);
+    cp_put_u8(s, entity->is_mutant);
+    cp_put_u32(s, entity->mutation_rate);
+    checkpoint_put_ref(s, &entity->state);
+    checkpoint_put_ref(s, &entity->task_vector);
+    uint8_t gene_count = 0;
+    for (struct Gene* g = entity->genome; g && gene_count < MAX_GENES_PER_ENTITY; g = g->next) {
+        gene_count++;
+    }
+    cp_put_u8(s, gene_count);
+    struct Gene* gene = entity->genome;
+    for (uint32_t i = 0; i < gene_count; i++, gene = gene->next) {
+        cp_put(s, gene->name, sizeof(gene->name));
+        cp_put_u32(s, gene->fitness);
+        cp_put_u8(s, gene->mutable);
+        checkpoint_put_ref(s, &gene->pattern);
+    }
+}
+
+static void checkpoint_get_entity(struct CheckpointStream* s, struct Entity* entity, int apply, uint32_t* heap_needed) {
+    memset(entity, 0, sizeof(*entity));
+    entity->id = cp_get_u32(s);
+    entity->age = cp_get_u32(s);
+    entity->interaction_count = cp_get_u32(s);
+    entity->is_active = cp_get_u8(s);
+    for (uint32_t i = 0; i < MAX_ENTITY_DOMAINS; i++) {
+        entity->specialization_scores[i] = cp_get_f32(s);
+    }
+    entity->resource_allocation = cp_get_f32(s);
+    entity->confidence = cp_get_f32(s);
+    cp_get(s, entity->domain_name, sizeof(entity->domain_name));
+    entity->domain_name[sizeof(entity->domain_name) - 1] = '\0';
+    entity->path_id = cp_get_u32(s);
+    entity->task_alignment = cp_get_f32(s);
+    entity->fitness_score = cp_get_u32(s);
+    entity->spawn_count = cp_get_u32(s);
+    entity->marked_for_gc = cp_get_u8(s);
+    entity->is_mutant = cp_get_u8(s);
+    entity->mutation_rate = cp_get_u32(s);
+    entity->state = checkpoint_get_ref(s);
+    entity->task_vector = checkpoint_get_ref(s);
+    uint32_t gene_count = cp_get_u8(s);
+    if (gene_count > MAX_GENES_PER_ENTITY) {
+        s->error = 1;
+        return;
+    }
+    struct Gene** tail = &entity->genome;
+    for (uint32_t i = 0; i < gene_count && !s->error; i++) {
+        struct Gene gene = {0};
+        cp_get(s, gene.name, sizeof(gene.name));
+        gene.name[sizeof(gene.name) - 1] = '\0';
+        gene.fitness = cp_get_u32(s);
+        gene.mutable = cp_get_u8(s);
+        gene.pattern = checkpoint_get_ref(s);
+        if (!apply) {
+            *heap_needed += (sizeof(struct Gene) + 7) & ~7;
+            continue;
+        }
+        struct Gene* copy = (struct Gene*)kmalloc(sizeof(struct Gene));
+        if (!copy) {
+            s->error = 1;
+            return;
+        }
+        *copy = gene;
+        *tail = copy;
+        tail = &copy->next;
+        entity->gene_count++;
+    }
+}
+
+// Parses a payload. The first pass (apply = 0) touches nothing but the
+// vector table, so a bad or oversized checkpoint leaves the population alone.
+static int checkpoint_parse(struct CheckpointStream* s, const struct CheckpointHeader* header, int apply) {
+    uint32_t heap_needed = 0;
+    if (header->entity_count > MAX_ENTITIES || header->memory_count > MAX_MEMORY_ENTRIES ||
+        header->thought_count > MAX_THOUGHTS || header->vector_count > CHECKPOINT_MAX_VECTORS) {
+        return -1;
+    }
+    uint32_t update_cycles = cp_get_u32(s);
+    uint32_t spawns = cp_get_u32(s);
+    uint32_t resonances = cp_get_u32(s);
+    uint32_t telemetry_sequence = cp_get_u32(s);
+    float coherence = cp_get_f32(s);
+    uint8_t rule_variants[DISPATCH_RULE_SLOTS];
+    for (uint32_t slot = 0; slot < DISPATCH_RULE_SLOTS; slot++) {
+        rule_variants[slot] = cp_get_u8(s);
+        if (rule_variants[slot] >= dispatch_slots[slot].variant_count) return -1;
+    }
+    checkpoint_vector_count = header->vector_count;
+    for (uint32_t i = 0; i < header->vector_count && !s->error; i++) {
+        checkpoint_get_block(s, i, apply, &heap_needed);
+    }
+    if (apply) {
+        memset(&holo_system, 0, sizeof(holo_system));
+        memset(&collective, 0, sizeof(collective));
+        memset(entity_pool, 0, sizeof(entity_pool));
+        holo_system.global_timestamp = header->global_timestamp;
+        holo_system.memory_count = header->memory_count;
+        collective.thought_count = header->thought_count;
+        collective.global_coherence = coherence;
+        active_entity_count = header->entity_count;
+        sim_stats.update_cycles = update_cycles;
+        sim_stats.spawns = spawns;
+        sim_stats.resonances = resonances;
+        sim_stats.telemetry_sequence = telemetry_sequence;
+        // The population evolved under these rule variants. Patches to the
+        // rule slots belong to the run being replaced, so they are settled
+        // first and cannot be reverted onto the restored selection.
+        uintptr_t table = (uintptr_t)&dispatch.fn[0];
+        patch_forget_range((uint32_t)table, (uint32_t)(table + DISPATCH_RULE_SLOTS * sizeof(dispatch_fn)));
+        for (uint32_t slot = 0; slot < DISPATCH_RULE_SLOTS; slot++) {
+            dispatch_fn fn = dispatch_slots[slot].variants[rule_variants[slot]].fn;
+            patch_write((uint8_t*)&dispatch.fn[slot], (const uint8_t*)&fn, sizeof(fn));
+        }
+        serialize_execution();
+    }
+    for (uint32_t i = 0; i < header->memory_count; i++) {
+        MemoryEntry entry;
+        entry.input_pattern = checkpoint_get_ref(s);
+        entry.output_pattern = checkpoint_get_ref(s);
+        entry.timestamp = cp_get_u32(s);
+        entry.valid = cp_get_u8(s);
+        if (apply) holo_system.memory_pool[i] = entry;
+    }
+    for (uint32_t i = 0; i < header->thought_count; i++) {
+        HyperVector thought = checkpoint_get_ref(s);
+        if (apply) collective.thought_space[i] = thought;
+    }
+    for (uint32_t i = 0; i < header->entity_count && !s->error; i++) {
+        struct Entity scratch;
+        checkpoint_get_entity(s, apply ? &entity_pool[i] : &scratch, apply, &heap_needed);
+    }
+    if (s->error || s->position != header->payload_length) return -1;
+    if (!apply && heap_needed >= heap_get_free_space()) {
+        klog(LOG_SUB_STORAGE, LOG_ERROR, "[CHECKPOINT] Not enough heap to restore: need ");
+        klog_dec(LOG_SUB_STORAGE, LOG_ERROR, heap_needed);
+        klog(LOG_SUB_STORAGE, LOG_ERROR, " bytes\n");
+        return -1;
+    }
+    return 0;
+}
+
+static uint32_t checkpoint_slot_lba(uint32_t sequence) {
+    return DATA_DISK_CHECKPOINT_LBA + (sequence & 1) * DATA_DISK_CHECKPOINT_SLOT_SECTORS;
+}
+
+static int checkpoint_save(void) {
+    if (!ata_disk.present) {
+        klog(LOG_SUB_STORAGE, LOG_WARN, "[CHECKPOINT] No data disk, not saved\n");
+        return -1;
+    }
+    struct CheckpointStream s = {(uint8_t*)CHECKPOINT_BUFFER_BASE, 0, CHECKPOINT_PAYLOAD_MAX, 0};
+    checkpoint_vector_count = 0;
+    for (uint32_t i = 0; i < holo_system.memory_count; i++) {
+        checkpoint_collect_vector(&s, &holo_system.memory_pool[i].input_pattern);
+        checkpoint_collect_vector(&s, &holo_system.memory_pool[i].output_pattern);
+    }
+    for (uint32_t i = 0; i < collective.thought_count; i++) {
+        checkpoint_collect_vector(&s, &collective.thought_space[i]);
+    }
+    for (uint32_t i = 0; i < active_entity_count; i++) {
+        checkpoint_collect_vector(&s, &entity_pool[i].state);
+        checkpoint_collect_vector(&s, &entity_pool[i].task_vector);
+        uint32_t genes = 0;
+        for (struct Gene* g = entity_pool[i].genome; g && genes < MAX_GENES_PER_ENTITY; g = g->next, genes++) {
+            checkpoint_collect_vector(&s, &g->pattern);
+        }
+    }
+    cp_put_u32(&s, sim_stats.update_cycles);
+    cp_put_u32(&s, sim_stats.spawns);
+    cp_put_u32(&s, sim_stats.resonances);
+    cp_put_u32(&s, sim_stats.telemetry_sequence);
+    cp_put_f32(&s, collective.global_coherence);
+    for (uint32_t slot = 0; slot < DISPATCH_RULE_SLOTS; slot++) {
+        cp_put_u8(&s, (uint8_t)dispatch_variant_index(slot));
+    }
+    for (uint32_t i = 0; i < checkpoint_vector_count; i++) {
+        checkpoint_put_block(&s, checkpoint_vectors[i], checkpoint_vector_capacity[i]);
+    }
+    for (uint32_t i = 0; i < holo_system.memory_count; i++) {
+        checkpoint_put_ref(&s, &holo_system.memory_pool[i].input_pattern);
+        checkpoint_put_ref(&s, &holo_system.memory_pool[i].output_pattern);
+        cp_put_u32(&s, holo_system.memory_pool[i].timestamp);
+        cp_put_u8(&s, holo_system.memory_pool[i].valid);
+    }
+    for (uint32_t i = 0; i < collective.thought_count; i++) {
+        checkpoint_put_ref(&s, &collective.thought_space[i]);
+    }
+    for (uint32_t i = 0; i < active_entity_count; i++) {
+        checkpoint_put_entity(&s, &entity_pool[i]);
+    }
+    if (s.error) {
+        klog(LOG_SUB_STORAGE, LOG_ERROR, "[CHECKPOINT] Population does not fit a checkpoint slot\n");
+        return -1;
+    }
+
+    struct CheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = CHECKPOINT_MAGIC;
+    header.version = CHECKPOINT_VERSION;
+    header.header_size = sizeof(header);
+    header.sequence = checkpoint_sequence + 1;
+    header.payload_length = s.position;
+    header.payload_crc32 = crc32_update(0, s.data, s.position);
+    header.global_timestamp = holo_system.global_timestamp;
+    header.entity_count = active_entity_count;
+    header.memory_count = holo_system.memory_count;
+    header.thought_count = collective.thought_count;
+    header.vector_count = checkpoint_vector_count;
+    header.header_crc32 = crc32_update(0, &header, sizeof(header) - sizeof(header.header_crc32));
+
+    uint32_t lba = checkpoint_slot_lba(header.sequence);
+    uint32_t sectors = (s.position + ATA_SECTOR_SIZE - 1) / ATA_SECTOR_SIZE;
+    memset(s.data + s.position, 0, sectors * ATA_SECTOR_SIZE - s.position);
+    memset(checkpoint_sector, 0, sizeof(checkpoint_sector));
+    memcpy(checkpoint_sector, &header, sizeof(header));
+    if (ata_write_sectors(lba + 1, sectors, s.data) != 0 || ata_flush() != 0 ||
+        ata_write_sectors(lba, 1, checkpoint_sector) != 0 || ata_flush() != 0) {
+        klog(LOG_SUB_STORAGE, LOG_ERROR, "[CHECKPOINT] Disk write failed\n");
+        return -1;
+    }
+    checkpoint_sequence = header.sequence;
+    klog(LOG_SUB_STORAGE, LOG_INFO, "[CHECKPOINT] Saved #");
+    klog_dec(LOG_SUB_STORAGE, LOG_INFO, header.sequence);
+    klog(LOG_SUB_STORAGE, LOG_INFO, ": ");
+    klog_dec(LOG_SUB_STORAGE, LOG_INFO, header.entity_count);
+    klog(LOG_SUB_STORAGE, LOG_INFO, " entities, ");
+    klog_dec(LOG_SUB_STORAGE, LOG_INFO, header.vector_count);
+    klog(LOG_SUB_STORAGE, LOG_INFO, " vectors, ");
+    klog_dec(LOG_SUB_STORAGE, LOG_INFO, header.payload_length);
+    klog(LOG_SUB_STORAGE, LOG_INFO, " bytes\n");
+    return 0;
+}
+
+static int checkpoint_read_header(uint32_t slot, struct CheckpointHeader* header) {
+    uint32_t lba = DATA_DISK_CHECKPOINT_LBA + slot * DATA_DISK_CHECKPOINT_SLOT_SECTORS;
+    if (ata_read_sectors(lba, 1, checkpoint_sector) != 0) return -1;
+    memcpy(header, checkpoint_sector, sizeof(*header));
+    if (header->magic != CHECKPOINT_MAGIC || header->version != CHECKPOINT_VERSION ||
+        header->header_size != sizeof(*header) || header->payload_length > CHECKPOINT_PAYLOAD_MAX ||
+        header->header_crc32 != crc32_update(0, header, sizeof(*header) - sizeof(header->header_crc32))) {
+        return -1;
+    }
+    return 0;
+}
+
+// Restores the newest valid checkpoint, falling back to the older slot.
+static int checkpoint_load(void) {
+    struct CheckpointHeader headers[2];
+    int valid[2];
+    if (!ata_disk.present) return -1;
+    for (uint32_t slot = 0; slot < 2; slot++) {
+        valid[slot] = checkpoint_read_header(slot, &headers[slot]) == 0;
+        if (valid[slot] && headers[slot].sequence > checkpoint_sequence) {
+            checkpoint_sequence = headers[slot].sequence; // Next save goes to the other slot
+        }
+    }
+    uint32_t first = (valid[1] && (!valid[0] || headers[1].sequence > headers[0].sequence)) ? 1 : 0;
+    for (uint32_t attempt = 0; attempt < 2; attempt++) {
+        uint32_t slot = attempt == 0 ? first : 1 - first;
+        if (!valid[slot]) continue;
+        struct CheckpointHeader* header = &headers[slot];
+        uint8_t* payload = (uint8_t*)CHECKPOINT_BUFFER_BASE;
+        uint32_t sectors = (header->payload_length + ATA_SECTOR_SIZE - 1) / ATA_SECTOR_SIZE;
+        uint32_t lba = DATA_DISK_CHECKPOINT_LBA + slot * DATA_DISK_CHECKPOINT_SLOT_SECTORS;
+        if (ata_read_sectors(lba + 1, sectors, payload) != 0 ||
+            crc32_update(0, payload, header->payload_length) != header->payload_crc32) {
+            klog(LOG_SUB_STORAGE, LOG_WARN, "[CHECKPOINT] Slot payload damaged, trying the other slot\n");
+            continue;
+        }
+        struct CheckpointStream s = {payload, 0, header->payload_length, 0};
+        if (checkpoint_parse(&s, header, 0) != 0) {
+            klog(LOG_SUB_STORAGE, LOG_WARN, "[CHECKPOINT] Slot payload inconsistent, trying the other slot\n");
+            continue;
+        }
+        s.position = 0;
+        checkpoint_parse(&s, header, 1);
+        patch_restart_trials();
+        klog(LOG_SUB_STORAGE, LOG_INFO, "[CHECKPOINT] Restored #");
+        klog_dec(LOG_SUB_STORAGE, LOG_INFO, header->sequence);
+        klog(LOG_SUB_STORAGE, LOG_INFO, " at timestamp ");
+        klog_dec(LOG_SUB_STORAGE, LOG_INFO, header->global_timestamp);
+        klog(LOG_SUB_STORAGE, LOG_INFO, ": ");
+        klog_dec(LOG_SUB_STORAGE, LOG_INFO, active_entity_count);
+        klog(LOG_SUB_STORAGE, LOG_INFO, " entities, ");
+        klog_dec(LOG_SUB_STORAGE, LOG_INFO, collective.thought_count);
+        klog(LOG_SUB_STORAGE, LOG_INFO, " thoughts\n");
+        return 0;
+    }
+    klog(LOG_SUB_STORAGE, LOG_INFO, "[CHECKPOINT] No usable checkpoint on the data disk\n");
+    return -1;
+}
+
+// --- POPULATION IMPORT / EXPORT ---
+// A population image (include/population.h) carries entities and their
+// genomes without the rest of the simulation, so evolved genomes can seed
+// another run. Patterns are stored sparse and quantized to 8 bits; shared
+// vector data is not preserved, unlike in a checkpoint. Export writes the
+// image to log sinks (tools/genome_tool extracts it from a capture); import
+// reads it from the data disk region written by `make population`.
+static int8_t population_quantize(float value, float scale) {
+    if (scale <= 0.0f) return 0;
+    float q = value / scale * POPULATION_QUANT_MAX;
+    return (int8_t)(q >= 0.0f ? q + 0.5f : q - 0.5f);
+}
+
+static void population_put_pattern(struct CheckpointStream* s, const HyperVector* vec) {
+    PopulationPattern pattern = {0, 0, 0, 0, 0.0f};
+    if (vec->data && vec->capacity <= MAX_DIMENSIONS) {
+        pattern.capacity = (uint16_t)vec->capacity;
+        pattern.active_dims = (uint16_t)vec->active_dims;
+        for (uint32_t i = 0; i < vec->capacity; i++) {
+            float magnitude = vec->data[i] < 0.0f ? -vec->data[i] : vec->data[i];
+            if (magnitude > pattern.scale) pattern.scale = magnitude;
+        }
+        for (uint32_t i = 0; i < vec->capacity; i++) {
+            if (population_quantize(vec->data[i], pattern.scale) != 0) pattern.nonzero++;
+        }
+    }
+    cp_put(s, &pattern, sizeof(pattern));
+    for (uint32_t i = 0; i < pattern.capacity; i++) {
+        PopulationDim dim;
+        dim.index = (uint16_t)i;
+        dim.value = population_quantize(vec->data[i], pattern.scale);
+        if (dim.value != 0) cp_put(s, &dim, sizeof(dim));
+    }
+}
+
+// Without `apply` only validates and counts the heap the pattern would need.
+static HyperVector population_get_pattern(struct CheckpointStream* s, int apply, uint32_t* heap_needed) {
+    HyperVector vec = {0};
+    PopulationPattern pattern;
+    cp_get(s, &pattern, sizeof(pattern));
+    if (pattern.capacity == 0) {
+        if (pattern.nonzero) s->error = 1;
+        return vec;
+    }
+    if (pattern.capacity > MAX_DIMENSIONS || pattern.nonzero > pattern.capacity ||
+        pattern.active_dims > pattern.capacity) {
+        s->error = 1;
+        return vec;
+    }
+    float* data = NULL;
+    if (apply) {
+        data = (float*)kmalloc(pattern.capacity * sizeof(float));
+        if (!data) {
+            s->error = 1;
+            return vec;
+        }
+        memset(data, 0, pattern.capacity * sizeof(float));
+    } else {
+        *heap_needed += (pattern.capacity * sizeof(float) + 7) & ~7;
+    }
+    for (uint32_t i = 0; i < pattern.nonzero && !s->error; i++) {
+        PopulationDim dim;
+        cp_get(s, &dim, sizeof(dim));
+        if (dim.index >= pattern.capacity) {
+            s->error = 1;
+            return vec;
+        }
+        if (data) data[dim.index] = (float)dim.value * pattern.scale / POPULATION_QUANT_MAX;
+    }
+    if (!data) return vec;
+    vec.data = data;
+    vec.capacity = pattern.capacity;
+    vec.active_dims = pattern.active_dims;
+    vec.hash_sig = hash_data(data, vec.active_dims * sizeof(float));
+    vec.valid = 1;
+    return vec;
+}
+
+static uint32_t population_put_entity(struct CheckpointStream* s, const struct Entity* entity) {
+    PopulationEntity record;
+    memset(&record, 0, sizeof(record));
+    record.id = entity->id;
+    record.age = entity->age;
+    record.fitness_score = entity->fitness_score;
+    record.mutation_rate = entity->mutation_rate;
+    record.spawn_count = entity->spawn_count;
+    record.path_id = entity->path_id;
+    record.confidence = entity->confidence;
+    record.resource_allocation = entity->resource_allocation;
+    record.task_alignment = entity->task_alignment;
+    for (uint32_t i = 0; i < MAX_ENTITY_DOMAINS; i++) {
+        record.specialization_scores[i] = entity->specialization_scores[i];
+    }
+    memcpy(record.domain_name, entity->domain_name, sizeof(record.domain_name));
+    record.is_active = entity->is_active;
+    record.is_mutant = entity->is_mutant;
+    for (struct Gene* g = entity->genome; g && record.gene_count < MAX_GENES_PER_ENTITY; g = g->next) {
+        record.gene_count++;
+    }
+    cp_put(s, &record, sizeof(record));
+    population_put_pattern(s, &entity->state);
+    population_put_pattern(s, &entity->task_vector);
+    struct Gene* gene = entity->genome;
+    for (uint32_t i = 0; i < record.gene_count; i++, gene = gene->next) {
+        PopulationGene gene_record;
+        memset(&gene_record, 0, sizeof(gene_record));
+        memcpy(gene_record.name, gene->name, sizeof(gene_record.name));
+        gene_record.fitness = gene->fitness;
+        gene_record.mutable = gene->mutable;
+        cp_put(s, &gene_record, sizeof(gene_record));
+        population_put_pattern(s, &gene->pattern);
+    }
+    return record.gene_count;
+}
+
+static uint32_t population_get_entity(struct CheckpointStream* s, struct Entity* entity, uint32_t slot,
+                                      int apply, uint32_t* heap_needed) {
+    PopulationEntity record;
+    cp_get(s, &record, sizeof(record));
+    if (record.gene_count > MAX_GENES_PER_ENTITY) {
+        s->error = 1;
+        return 0;
+    }
+    memset(entity, 0, sizeof(*entity));
+    entity->id = slot;
+    entity->age = record.age;
+    entity->fitness_score = record.fitness_score;
+    entity->mutation_rate = record.mutation_rate > 1000 ? 1000 : record.mutation_rate;
+    entity->spawn_count = record.spawn_count;
+    entity->path_id = record.path_id;
+    entity->confidence = record.confidence;
+    entity->resource_allocation = record.resource_allocation;
+    entity->task_alignment = record.task_alignment;
+    for (uint32_t i = 0; i < MAX_ENTITY_DOMAINS; i++) {
+        entity->specialization_scores[i] = record.specialization_scores[i];
+    }
+    memcpy(entity->domain_name, record.domain_name, sizeof(entity->domain_name));
+    entity->domain_name[sizeof(entity->domain_name) - 1] = '\0';
+    entity->is_active = record.is_active ? 1 : 0;
+    entity->is_mutant = record.is_mutant ? 1 : 0;
+    entity->state = population_get_pattern(s, apply, heap_needed);
+    entity->task_vector = population_get_pattern(s, apply, heap_needed);
+    struct Gene** tail = &entity->genome;
+    for (uint32_t i = 0; i < record.gene_count && !s->error; i++) {
+        PopulationGene gene_record;
+        cp_get(s, &gene_record, sizeof(gene_record));
+        HyperVector pattern = population_get_pattern(s, apply, heap_needed);
+        if (!apply) {
+            *heap_needed += (sizeof(struct Gene) + 7) & ~7;
+            continue;
+        }
+        struct Gene* gene = (struct Gene*)kmalloc(sizeof(struct Gene));
+        if (!gene) {
+            s->error = 1;
+            break;
+        }
+        memset(gene, 0, sizeof(*gene));
+        memcpy(gene->name, gene_record.name, sizeof(gene->name));
+        gene->name[sizeof(gene->name) - 1] = '\0';
+        gene->fitness = gene_record.fitness;
+        gene->mutable = gene_record.mutable ? 1 : 0;
+        gene->pattern = pattern;
+        *tail = gene;
+        tail = &gene->next;
+        entity->gene_count++;
+    }
+    return record.gene_count;
+}
+
+// Like checkpoint_parse: the first pass (apply = 0) changes nothing.
+static int population_parse(struct CheckpointStream* s, const PopulationHeader* header, int apply) {
+    uint32_t heap_needed = 0;
+    uint32_t genes = 0;
+    if (header->entity_count > MAX_ENTITIES) return -1;
+    if (apply) {
+        memset(entity_pool, 0, sizeof(entity_pool));
+        active_entity_count = header->entity_count;
+    }
+    for (uint32_t i = 0; i < header->entity_count && !s->error; i++) {
+        struct Entity scratch;
+        genes += population_get_entity(s, apply ? &entity_pool[i] : &scratch, i, apply, &heap_needed);
+    }
+    if (s->error || s->position != header->payload_length || genes != header->gene_count) return -1;
+    if (!apply && heap_needed >= heap_get_free_space()) {
+        klog(LOG_SUB_STORAGE, LOG_ERROR, "[POPULATION] Not enough heap to import: need ");
+        klog_dec(LOG_SUB_STORAGE, LOG_ERROR, heap_needed);
+        klog(LOG_SUB_STORAGE, LOG_ERROR, " bytes\n");
+        return -1;
+    }
+    return 0;
+}
+
+static int population_export(uint8_t sinks) {
+    uint8_t* staging = (uint8_t*)CHECKPOINT_BUFFER_BASE;
+    struct CheckpointStream s = {staging + sizeof(PopulationHeader), 0, POPULATION_PAYLOAD_MAX, 0};
+    PopulationHeader header;
+    header.gene_count = 0;
+    for (uint32_t i = 0; i < active_entity_count; i++) {
+        header.gene_count += population_put_entity(&s, &entity_pool[i]);
+    }
+    if (s.error) {
+        klog(LOG_SUB_STORAGE, LOG_ERROR, "[POPULATION] Population too large to export\n");
+        return -1;
+    }
+    header.magic = POPULATION_MAGIC;
+    header.version = POPULATION_VERSION;
+    header.header_size = sizeof(header);
+    header.entity_count = active_entity_count;
+    header.payload_length = s.position;
+    header.payload_crc32 = crc32_update(0, s.data, s.position);
+    header.header_crc32 = crc32_update(0, &header, sizeof(header) - sizeof(header.header_crc32));
+    memcpy(staging, &header, sizeof(header));
+    log_emit_bytes(sinks, staging, sizeof(header) + s.position);
+    klog(LOG_SUB_STORAGE, LOG_INFO, "[POPULATION] Exported ");
+    klog_dec(LOG_SUB_STORAGE, LOG_INFO, header.entity_count);
+    klog(LOG_SUB_STORAGE, LOG_INFO, " entities, ");
+    klog_dec(LOG_SUB_STORAGE, LOG_INFO, header.gene_count);
+    klog(LOG_SUB_STORAGE, LOG_INFO, " genes, ");
+    klog_dec(LOG_SUB_STORAGE, LOG_INFO, sizeof(header) + s.position);
+    klog(LOG_SUB_STORAGE, LOG_INFO, " bytes\n");
+    return 0;
+}
+
+// Replaces the entity pool with the data disk's population image. Returns
+// 0 on success; on any error the current population is left untouched.
+static int population_import(void) {
+    uint8_t* staging = (uint8_t*)CHECKPOINT_BUFFER_BASE;
+    PopulationHeader header;
+    if (!ata_disk.present || ata_read_sectors(DATA_DISK_POPULATION_LBA, 1, staging) != 0) return -1;
+    memcpy(&header, staging, sizeof(header));
+    if (header.magic != POPULATION_MAGIC) {
+        klog(LOG_SUB_STORAGE, LOG_INFO, "[POPULATION] No population image on the data disk\n");
+        return -1;
+    }
+    if (header.version != POPULATION_VERSION || header.header_size != sizeof(header) ||
+        header.payload_length > POPULATION_PAYLOAD_MAX ||
+        crc32_update(0, &header, sizeof(header) - sizeof(header.header_crc32)) != header.header_crc32) {
+        klog(LOG_SUB_STORAGE, LOG_WARN, "[POPULATION] Bad population header, ignored\n");
+        return -1;
+    }
+    uint32_t sectors = (sizeof(header) + header.payload_length + ATA_SECTOR_SIZE - 1) / ATA_SECTOR_SIZE;
+    struct CheckpointStream s = {staging + sizeof(header), 0, header.payload_length, 0};
+    if (sectors > 1 && ata_read_sectors(DATA_DISK_POPULATION_LBA + 1, sectors - 1, staging + ATA_SECTOR_SIZE) != 0) {
+        klog(LOG_SUB_STORAGE, LOG_ERROR, "[POPULATION] Read error\n");
+        return -1;
+    }
+    if (crc32_update(0, s.data, header.payload_length) != header.payload_crc32 ||
+        population_parse(&s, &header, 0) != 0) {
+        klog(LOG_SUB_STORAGE, LOG_WARN, "[POPULATION] Corrupt population image, ignored\n");
+        return -1;
+    }
+    s.position = 0;
+    if (population_parse(&s, &header, 1) != 0) {
+        klog(LOG_SUB_STORAGE, LOG_ERROR, "[POPULATION] Import failed after validation\n");
+        return -1;
+    }
+    patch_restart_trials();
+    klog(LOG_SUB_STORAGE, LOG_INFO, "[POPULATION] Imported ");
+    klog_dec(LOG_SUB_STORAGE, LOG_INFO, header.entity_count);
+    klog(LOG_SUB_STORAGE, LOG_INFO, " entities, ");
+    klog_dec(LOG_SUB_STORAGE, LOG_INFO, header.gene_count);
+    klog(LOG_SUB_STORAGE, LOG_INFO, " genes\n");
+    return 0;
+}
+
+// --- RECORD / REPLAY JOURNAL ---
+// The simulation is deterministic given its starting state and the
+// main-loop iteration at which each serial command runs: update cycles fall
+// every update_interval iterations and all randomness derives from
+// global_timestamp. Recording (journal_mode=1) therefore logs each command
+// with its global_timestamp, plus a state digest every JOURNAL_SYNC_INTERVAL
+// update cycles, flushed to the data disk as it goes. Replay
+// (journal_mode=2) checks the starting state, re-issues the commands at
+// the same timestamps, compares the digests, and runs without hlt so the
+// replay doubles as a fixed workload for benchmarks.
+#define JOURNAL_RECORD_COMMAND 1           // Payload: command text
+#define JOURNAL_RECORD_SYNC 2              // Payload: update_cycles, state digest, timer_ticks
+struct JournalState {
+    uint32_t requested_mode;               // journal_mode parameter, read at main-loop entry
+    uint32_t mode;
+    uint32_t length;                       // Record bytes written, or the replay read position
+    uint32_t flushed_sectors;              // Record sectors already on disk, the last one partial
+    uint32_t divergences;
+    uint64_t replay_start_tsc;
+    uint32_t replay_start_ticks;
+    struct JournalHeader header;
+};
+static struct JournalState journal = {JOURNAL_MODE_OFF, JOURNAL_MODE_OFF, 0, 0, 0, 0, 0, {0}};
+
+static int journal_replaying(void) {
+    return journal.mode == JOURNAL_MODE_REPLAY;
+}
+
+// Recording or replaying was asked for, so decisions must not depend on timing
+static int journal_enabled(void) {
+    return journal.requested_mode != JOURNAL_MODE_OFF;
+}
+
+// Everything the simulation's future depends on, reduced to 32 bits
+static uint32_t journal_state_digest(void) {
+    uint32_t words[6];
+    uint32_t digest = hash_data(&holo_system.global_timestamp, sizeof(uint32_t));
+    for (uint32_t i = 0; i < active_entity_count; i++) {
+        const struct Entity* entity = &entity_pool[i];
+        words[0] = digest;
+        words[1] = entity->fitness_score;
+        words[2] = entity->age ^ (entity->gene_count << 16) ^ ((uint32_t)entity->is_active << 31);
+        words[3] = entity->state.data ? hash_data(entity->state.data, entity->state.active_dims * sizeof(float)) : 0;
+        words[4] = entity->mutation_rate ^ (entity->spawn_count << 12);
+        words[5] = entity->genome ? entity->genome->fitness : 0;
+        digest = hash_data(words, sizeof(words));
+    }
+    words[0] = digest;
+    words[1] = active_entity_count;
+    words[2] = collective.thought_count;
+    words[3] = holo_system.memory_count;
+    words[4] = sim_stats.spawns;
+    words[5] = sim_stats.resonances;
+    return hash_data(words, sizeof(words));
+}
+
+static void journal_finish_header(void) {
+    struct JournalHeader* header = &journal.header;
+    header->records_length = journal.length;
+    header->records_crc32 = crc32_update(0, (const uint8_t*)JOURNAL_BUFFER_BASE, journal.length);
+    header->header_crc32 = crc32_update(0, header, sizeof(*header) - sizeof(header->header_crc32));
+}
+
+// Writes the record sectors not yet on disk (rewriting the partial last one), then the header.
+static int journal_flush(void) {
+    uint32_t sectors = (journal.length + ATA_SECTOR_SIZE - 1) / ATA_SECTOR_SIZE;
+    uint32_t first = journal.flushed_sectors ? journal.flushed_sectors - 1 : 0;
+    if (journal.mode != JOURNAL_MODE_RECORD) return 0;
+    if (sectors > first &&
+        ata_write_sectors(DATA_DISK_JOURNAL_LBA + 1 + first, sectors - first,
+                          (const uint8_t*)JOURNAL_BUFFER_BASE + first * ATA_SECTOR_SIZE) != 0) {
+        klog(LOG_SUB_STORAGE, LOG_ERROR, "[JOURNAL] Write failed, recording stopped\n");
+        journal.mode = JOURNAL_MODE_OFF;
+        return -1;
+    }
+    journal.flushed_sectors = sectors;
+    journal_finish_header();
+    memset(checkpoint_sector, 0, sizeof(checkpoint_sector));
+    memcpy(checkpoint_sector, &journal.header, sizeof(journal.header));
+    if (ata_write_sectors(DATA_DISK_JOURNAL_LBA, 1, checkpoint_sector) != 0 || ata_flush() != 0) {
+        klog(LOG_SUB_STORAGE, LOG_ERROR, "[JOURNAL] Header write failed, recording stopped\n");
+        journal.mode = JOURNAL_MODE_OFF;
+        return -1;
+    }
+    return 0;
+}
+
+static void journal_append(uint8_t type, const void* payload, uint32_t length) {
+    uint8_t* records = (uint8_t*)JOURNAL_BUFFER_BASE;
+    if (journal.mode != JOURNAL_MODE_RECORD) return;
+    if (6 + length > JOURNAL_RECORDS_MAX - journal.length) {
+        klog(LOG_SUB_STORAGE, LOG_WARN, "[JOURNAL] Journal full, recording stopped\n");
+        journal_flush();
+        journal.mode = JOURNAL_MODE_OFF;
+        return;
+    }
+    uint32_t timestamp = holo_system.global_timestamp;
+    records[journal.length] = type;
+    records[journal.length + 1] = (uint8_t)length;
+    memcpy(records + journal.length + 2, &timestamp, 4);
+    memcpy(records + journal.length + 6, payload, length);
+    journal.length += 6 + length;
+    journal.header.record_count++;
+}
+
+static int journal_load(void) {
+    struct JournalHeader* header = &journal.header;
+    if (!ata_disk.present || ata_read_sectors(DATA_DISK_JOURNAL_LBA, 1, checkpoint_sector) != 0) return -1;
+    memcpy(header, checkpoint_sector, sizeof(*header));
+    if (header->magic != JOURNAL_MAGIC || header->version != JOURNAL_VERSION ||
+        header->header_size != sizeof(*header) || header->records_length > JOURNAL_RECORDS_MAX ||
+        crc32_update(0, header, sizeof(*header) - sizeof(header->header_crc32)) != header->header_crc32) {
+        return -1;
+    }
+    uint32_t sectors = (header->records_length + ATA_SECTOR_SIZE - 1) / ATA_SECTOR_SIZE;
+    if (sectors && ata_read_sectors(DATA_DISK_JOURNAL_LBA + 1, sectors, (void*)JOURNAL_BUFFER_BASE) != 0) return -1;
+    if (crc32_update(0, (const uint8_t*)JOURNAL_BUFFER_BASE, header->records_length) != header->records_crc32) return -1;
+    return 0;
+}
+
+// Called once at main-loop entry: everything before it is boot, which the
+// journal does not record but checks through the start digest.
+static void journal_begin(void) {
+    uint32_t digest = journal_state_digest();
+    uint32_t params_digest = hash_data(&params, sizeof(params));
+    memset(&journal.header, 0, sizeof(journal.header));
+    journal.length = 0;
+    journal.flushed_sectors = 0;
+    journal.divergences = 0;
+    journal.mode = JOURNAL_MODE_OFF;
+    if (journal.requested_mode == JOURNAL_MODE_RECORD) {
+        journal.header.magic = JOURNAL_MAGIC;
+        journal.header.version = JOURNAL_VERSION;
+        journal.header.header_size = sizeof(journal.header);
+        journal.header.start_timestamp = holo_system.global_timestamp;
+        journal.header.start_digest = digest;
+        journal.header.params_digest = params_digest;
+        journal.mode = JOURNAL_MODE_RECORD;
+        if (journal_flush() == 0) klog(LOG_SUB_STORAGE, LOG_INFO, "[JOURNAL] Recording\n");
+    } else if (journal.requested_mode == JOURNAL_MODE_REPLAY) {
+        if (journal_load() != 0) {
+            klog(LOG_SUB_STORAGE, LOG_ERROR, "[JOURNAL] No valid journal on the data disk, replay off\n");
+            return;
+        }
+        if (journal.header.start_timestamp != holo_system.global_timestamp ||
+            journal.header.start_digest != digest || journal.header.params_digest != params_digest) {
+            klog(LOG_SUB_STORAGE, LOG_WARN, "[JOURNAL] Starting state or parameters differ from the recording; replay will diverge\n");
+            journal.divergences++;
+        }
+        journal.mode = JOURNAL_MODE_REPLAY;
+        journal.replay_start_tsc = rdtsc();
+        journal.replay_start_ticks = timer_ticks;
+        klog(LOG_SUB_STORAGE, LOG_INFO, "[JOURNAL] Replaying ");
+        klog_dec(LOG_SUB_STORAGE, LOG_INFO, journal.header.record_count);
+        klog(LOG_SUB_STORAGE, LOG_INFO, " records\n");
+    }
+}
+
+static void journal_replay_finish(void) {
+    uint64_t cycles = rdtsc() - journal.replay_start_tsc;
+    journal.mode = JOURNAL_MODE_OFF;
+    klog(LOG_SUB_STORAGE, LOG_INFO, "[JOURNAL] Replay complete: ");
+    klog_dec(LOG_SUB_STORAGE, LOG_INFO, sim_stats.update_cycles);
+    klog(LOG_SUB_STORAGE, LOG_INFO, " update cycles in ");
+    klog_dec(LOG_SUB_STORAGE, LOG_INFO, timer_ticks - journal.replay_start_ticks);
+    klog(LOG_SUB_STORAGE, LOG_INFO, " ms, ");
+    klog_dec64(LOG_SUB_STORAGE, LOG_INFO, cycles);
+    klog(LOG_SUB_STORAGE, LOG_INFO, " TSC cycles, ");
+    klog_dec(LOG_SUB_STORAGE, LOG_INFO, journal.divergences);
+    klog(LOG_SUB_STORAGE, LOG_INFO, " divergences\n");
+}
+
+// Runs every replay record that is due at the current global_timestamp:
+// commands from the main loop before the update check, as serial input
+// is, and syncs right after the update cycle that recorded them.
+static void journal_replay_records(int after_update) {
+    const uint8_t* records = (const uint8_t*)JOURNAL_BUFFER_BASE;
+    while (journal.mode == JOURNAL_MODE_REPLAY) {
+        if (journal.length >= journal.header.records_length) {
+            journal_replay_finish();
+            return;
+        }
+        uint32_t timestamp;
+        uint8_t type = records[journal.length];
+        uint32_t length = records[journal.length + 1];
+        memcpy(&timestamp, records + journal.length + 2, 4);
+        if (journal.length + 6 + length > journal.header.records_length) {
+            klog(LOG_SUB_STORAGE, LOG_ERROR, "[JOURNAL] Truncated record, replay stopped\n");
+            journal.mode = JOURNAL_MODE_OFF;
+            return;
+        }
+        if ((type == JOURNAL_RECORD_SYNC) != after_update && timestamp == holo_system.global_timestamp) return;
+        if (timestamp != holo_system.global_timestamp) {
+            // Records are in timestamp order; one in the past can never match again
+            if ((int32_t)(timestamp - holo_system.global_timestamp) > 0) return;
+            journal.divergences++;
+        } else if (type == JOURNAL_RECORD_COMMAND && length <= SERIAL_COMMAND_MAX) {
+            char line[SERIAL_COMMAND_MAX + 1];
+            memcpy(line, records + journal.length + 6, length);
+            line[length] = '\0';
+            serial_print("[REPLAY] ");
+            serial_print(line);
+            serial_print("\n");
+            serial_command_execute(line);
+        } else if (type == JOURNAL_RECORD_SYNC) {
+            uint32_t recorded[3];
+            memcpy(recorded, records + journal.length + 6, sizeof(recorded));
+            if (recorded[0] != sim_stats.update_cycles || recorded[1] != journal_state_digest()) {
+                if (!journal.divergences) {
+                    klog(LOG_SUB_STORAGE, LOG_WARN, "[JOURNAL] Replay diverged at timestamp ");
+                    klog_dec(LOG_SUB_STORAGE, LOG_WARN, timestamp);
+                    klog(LOG_SUB_STORAGE, LOG_WARN, "\n");
+                }
+                journal.divergences++;
+            }
+        }
+        journal.length += 6 + length;
+    }
+}
+
+static void journal_replay_poll(void) {
+    journal_replay_records(0);
+}
+
+// Live serial input: recorded before it runs, and refused during a replay
+// (it would change the outcome) except for `journal` itself.
+static void journal_command(char* line) {
+    uint32_t length = (uint32_t)strlen(line);
+    char first[SERIAL_COMMAND_MAX + 1];
+    char* cursor = first;
+    memcpy(first, line, length + 1);
+    char* command = next_token(&cursor);
+    int control = command && str_equal(command, "journal");
+    if (journal.mode == JOURNAL_MODE_REPLAY && !control) {
+        if (command) serial_print("[CMD] replay in progress, only 'journal' is accepted\n");
+        return;
+    }
+    // Journal control is not simulation input, so it is never recorded
+    if (length && !control) journal_append(JOURNAL_RECORD_COMMAND, line, length);
+    serial_command_execute(line);
+}
+
+static void journal_update_cycle(void) {
+    if (journal.mode == JOURNAL_MODE_REPLAY) journal_replay_records(1);
+    if (journal.mode != JOURNAL_MODE_RECORD || sim_stats.update_cycles % JOURNAL_SYNC_INTERVAL != 0) return;
+    uint32_t sync[3] = {sim_stats.update_cycles, journal_state_digest(), timer_ticks};
+    journal_append(JOURNAL_RECORD_SYNC, sync, sizeof(sync));
+    journal_flush();
+}
+
+static void command_journal(char* cursor) {
+    static const char* const mode_names[] = {"off", "recording", "replaying"};
+    char* arg = next_token(&cursor);
+    if (arg && str_equal(arg, "flush")) {
+        journal_flush();
+    } else if (arg && str_equal(arg, "stop")) {
+        journal_flush();
+        journal.mode = JOURNAL_MODE_OFF;
+    }
+    serial_print("[JOURNAL] ");
+    serial_print(mode_names[journal.mode]);
+    serial_print(", ");
+    serial_print_dec(journal.header.record_count);
+    serial_print(" records, ");
+    serial_print_dec(journal.length);
+    serial_print(" bytes, ");
+    serial_print_dec(journal.divergences);
+    serial_print(" divergences\n");
+}
+
+// --- KERNEL AUTOTUNER ---
+// Times every variant of each similarity, merge and hash slot on a vector of
+// the slot's class size and installs the fastest, which differs between CPU
+// models and between TCG and KVM. It runs at boot, every autotune_interval
+// update cycles, and on the `autotune` command, always between update cycles.
+// Similarity variants round differently, so the autotuner stays off while a
+// journal records or replays: both runs must use the same kernels.
+static float autotune_a[MAX_DIMENSIONS];
+static float autotune_b[MAX_DIMENSIONS];
+static volatile uint32_t autotune_sink;   // Keeps timed calls from being optimised away
+
+static uint32_t autotune_time(uint32_t slot, dispatch_fn fn, uint32_t dims) {
+    uint32_t best = 0xFFFFFFFF;
+    for (uint32_t rep = 0; rep < AUTOTUNE_REPETITIONS; rep++) {
+        uint64_t start = rdtsc();
+        if (slot < DISPATCH_MERGE) {
+            float similarity = ((similarity_fn)fn)(autotune_a, autotune_b, dims);
+            autotune_sink += (uint32_t)(similarity * 1000.0f);
+        } else if (slot < DISPATCH_HASH) {
+            ((merge_fn)fn)(autotune_a, autotune_b, dims);
+        } else {
+            autotune_sink += ((hash_fn)fn)(autotune_a, dims * sizeof(float));
+        }
+        uint64_t cycles = rdtsc() - start;
+        if (cycles < best) best = (uint32_t)cycles;
+    }
+    return best;
+}
+
+static void autotune_run(void) {
+    uint32_t swapped = 0;
+    if (journal.requested_mode != JOURNAL_MODE_OFF) return;
+    for (uint32_t slot = DISPATCH_SIMILARITY; slot < DISPATCH_SLOT_COUNT; slot++) {
+        const struct DispatchSlot* info = &dispatch_slots[slot];
+        uint32_t winner = 0;
+        for (uint32_t i = 0; i < info->bench_dims; i++) {
+            // Merges pull a towards b; refill so every variant sees the same data
+            autotune_a[i] = (float)((i * 7919) % 1000) / 1000.0f - 0.5f;
+            autotune_b[i] = (float)((i * 104729) % 1000) / 1000.0f - 0.5f;
+        }
+        for (uint32_t v = 0; v < info->variant_count; v++) {
+            autotune.cycles[slot][v] = autotune_time(slot, info->variants[v].fn, info->bench_dims);
+            if (autotune.cycles[slot][v] < autotune.cycles[slot][winner]) winner = v;
+        }
+        if (info->variants[winner].fn != dispatch.fn[slot]) {
+            dispatch_fn fn = info->variants[winner].fn;
+            patch_write((uint8_t*)&dispatch.fn[slot], (const uint8_t*)&fn, sizeof(fn));
+            swapped++;
+        }
+    }
+    if (swapped) serialize_execution();
+    autotune.runs++;
+    klog(LOG_SUB_PATCH, LOG_INFO, "[AUTOTUNE] Run ");
+    klog_dec(LOG_SUB_PATCH, LOG_INFO, autotune.runs);
+    klog(LOG_SUB_PATCH, LOG_INFO, ", ");
+    klog_dec(LOG_SUB_PATCH, LOG_INFO, swapped);
+    klog(LOG_SUB_PATCH, LOG_INFO, " kernel slots changed\n");
+}
+
+static void command_jit(char* cursor) {
+    char* action = next_token(&cursor);
+    if (action && str_equal(action, "flush")) {
+        jit_flush();
+    } else if (action) {
+        serial_print("[CMD] usage: jit [flush]\n");
+        return;
+    }
+    static const char* const modes[] = {"off", "jit", "vm"};
+    serial_print("[RULES] gene_rules ");
+    serial_print(params.gene_rules <= RULE_EXEC_VM ? modes[params.gene_rules] : "?");
+    serial_print("\n[JIT] arena ");
+    serial_print_dec(jit.used);
+    serial_print("/");
+    serial_print_dec(JIT_ARENA_SIZE);
+    serial_print(" bytes, ");
+    serial_print_dec(jit.compiles);
+    serial_print(" compiles, ");
+    serial_print_dec(jit.hits);
+    serial_print(" hits, ");
+    serial_print_dec(jit.flushes);
+    serial_print(" flushes\n[VM] ");
+    serial_print_dec(vm.batches);
+    serial_print(" batches, ");
+    serial_print_dec(vm.lanes);
+    serial_print(" lanes, ");
+    serial_print_dec(vm.dispatches);
+    serial_print(" dispatches, ");
+    serial_print_dec(vm.rejected);
+    serial_print(" rejected\n");
+}
+
+// Counts timer samples per function and lists the busiest. Samples that
+// no symbol covers (or all of them, with no table) count as unknown.
+// Generated rule code runs from jit_arena, a sized object the symbol
+// table keeps, so its samples are listed under that name.
+static void command_profile(char* cursor) {
+    static uint32_t bucket_address[PROFILE_BUCKETS];
+    static uint32_t bucket_count[PROFILE_BUCKETS];
+    char* action = next_token(&cursor);
+    if (action && str_equal(action, "clear")) {
+        profile_ring.head = 0;
+        profile_ring.count = 0;
+        return;
+    } else if (action) {
+        serial_print("[CMD] usage: profile [clear]\n");
+        return;
+    }
+    uint32_t count = profile_ring.count, head = profile_ring.head, unknown = 0, other = 0;
+    memset(bucket_count, 0, sizeof(bucket_count));
+    for (uint32_t i = 0; i < count; i++) {
+        const SymbolEntry* entry = symbol_find(profile_ring.ip[(head + PROFILE_SAMPLES - count + i) % PROFILE_SAMPLES]);
+        if (!entry) {
+            unknown++;
+            continue;
+        }
+        uint32_t bucket = (entry->address * 2654435761U) >> 24 & (PROFILE_BUCKETS - 1);
+        uint32_t probes = 0;
+        while (bucket_count[bucket] && bucket_address[bucket] != entry->address && probes++ < PROFILE_BUCKETS) {
+            bucket = (bucket + 1) & (PROFILE_BUCKETS - 1);
+        }
+        if (probes >= PROFILE_BUCKETS) {
+            other++;
+            continue;
+        }
+        bucket_address[bucket] = entry->address;
+        bucket_count[bucket]++;
+    }
+    serial_print("[PROFILE] ");
+    serial_print_dec(count);
+    serial_print(" samples, ");
+    serial_print_dec(unknown);
+    serial_print(" outside known symbols\n");
+    for (uint32_t rank = 0; rank < PROFILE_TOP; rank++) {
+        uint32_t best = 0;
+        for (uint32_t b = 1; b < PROFILE_BUCKETS; b++) {
+            if (bucket_count[b] > bucket_count[best]) best = b;
+        }
+        if (!bucket_count[best]) break;
+        serial_print("  ");
+        serial_print_dec(bucket_count[best] * 100 / count);
+        serial_print("% ");
+        serial_print_dec(bucket_count[best]);
+        serial_print(" ");
+        serial_print(symbol_name(symbol_find(bucket_address[best])));
+        serial_print("\n");
+        bucket_count[best] = 0;
+    }
+    if (other) {
+        serial_print("  ");
+        serial_print_dec(other);
+        serial_print(" in further functions\n");
+    }
+}
+
+static void command_autotune(void) {
+    autotune_run();
+    if (journal.requested_mode != JOURNAL_MODE_OFF) {
+        serial_print("[CMD] autotuner is off while journal_mode is set\n");
+        return;
+    }
+    for (uint32_t slot = DISPATCH_SIMILARITY; slot < DISPATCH_SLOT_COUNT; slot++) {
+        const struct DispatchSlot* info = &dispatch_slots[slot];
+        uint32_t selected = dispatch_variant_index(slot);
+        serial_print("[AUTOTUNE] ");
+        serial_print(info->name);
+        serial_print(" (");
+        serial_print_dec(info->bench_dims);
+        serial_print(" dims):");
+        for (uint32_t v = 0; v < info->variant_count; v++) {
+            serial_print(v == selected ? " [" : " ");
+            serial_print(info->variants[v].name);
+            serial_print(" ");
+            serial_print_dec(autotune.cycles[slot][v]);
+            if (v == selected) serial_print("]");
+        }
+        serial_print("\n");
+    }
+}
+
+// --- SERIAL COMMAND CHANNEL ---
+// Line-oriented commands on COM1, executed from the main loop between
+// update cycles. The IRQ handler only fills serial_rx.
+static const struct {
+    const char* name;
+    uint32_t* value;
+} param_table[] = {
+    {"update_interval", &params.update_interval},
+    {"resonance_threshold", &params.resonance_threshold},
+    {"patch_confidence", &params.patch_confidence},
+    {"patch_fitness", &params.patch_fitness},
+    {"patch_mutation_rate", &params.patch_mutation_rate},
+    {"mutation_rate", &params.mutation_rate},
+    {"spawn_mutation_rate", &params.spawn_mutation_rate},
+    {"log_level", &log_config.level},
+    {"top_k", &params.top_k},
+    {"telemetry_interval", &params.telemetry_interval},
+    {"vbe_heatmap", &params.vbe_heatmap},
+    {"checkpoint_interval", &params.checkpoint_interval},
+    {"restore_checkpoint", &params.restore_checkpoint},
+    {"import_population", &params.import_population},
+    {"self_modify", &params.self_modify},
+    {"patch_rate", &params.patch_rate},
+    {"patch_trial_cycles", &params.patch_trial_cycles},
+    {"patch_regression", &params.patch_regression},
+    {"patch_slowdown", &params.patch_slowdown},
+    {"autotune", &params.autotune},
+    {"autotune_interval", &params.autotune_interval},
+    {"gene_rules", &params.gene_rules},
+    {"profile", &params.profile},
+    {"journal_mode", &journal.requested_mode},
+};
+#define PARAM_COUNT (sizeof(param_table) / sizeof(param_table[0]))
+static char serial_command_line[SERIAL_COMMAND_MAX + 1];
+static uint32_t serial_command_length = 0;
+
+static int parse_uint(const char* str, uint32_t* out) {
+    uint32_t value = 0;
+    uint32_t base = 10;
+    if (str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
+        base = 16;
+        str += 2;
+    }
+    if (!*str) return 0;
+    for (; *str; str++) {
+        uint32_t digit;
+        if (*str >= '0' && *str <= '9') digit = (uint32_t)(*str - '0');
+        else if (base == 16 && *str >= 'a' && *str <= 'f') digit = (uint32_t)(*str - 'a' + 10);
+        else if (base == 16 && *str >= 'A' && *str <= 'F') digit = (uint32_t)(*str - 'A' + 10);
+        else return 0;
+        value = value * base + digit;
+    }
+    *out = value;
+    return 1;
+}
+
+static char* next_token(char** cursor) {
+    char* p = *cursor;
+    while (*p == ' ' || *p == '\t') p++;
+    if (!*p) {
+        *cursor = p;
+        return NULL;
+    }
+    char* start = p;
+    while (*p && *p != ' ' && *p != '\t') p++;
+    if (*p) *p++ = '\0';
+    *cursor = p;
+    return start;
+}
+
+static uint32_t* find_param(const char* name) {
+    for (uint32_t i = 0; i < PARAM_COUNT; i++) {
+        if (str_equal(param_table[i].name, name)) return param_table[i].value;
+    }
+    return NULL;
+}
+
+static void print_param(uint32_t index) {
+    serial_print("  ");
+    serial_print(param_table[index].name);
+    serial_print(" = ");
+    serial_print_dec(*param_table[index].value);
+    serial_print("\n");
+}
+
+static void print_entity_line(struct Entity* entity) {
+    serial_print("  id ");
+    serial_print_dec(entity->id);
+    serial_print(entity->is_active ? " active " : " dormant ");
+    serial_print(" fitness ");
+    serial_print_dec(entity->fitness_score);
+    serial_print(" confidence ");
+    serial_print_dec((uint32_t)(entity->confidence * 1000));
+    serial_print(" age ");
+    serial_print_dec(entity->age);
+    serial_print(" genes ");
+    serial_print_dec(entity->gene_count);
+    serial_print(" mutation ");
+    serial_print_dec(entity->mutation_rate);
+    serial_print(" state ");
+    serial_print_hex(entity->state.hash_sig);
+    serial_print(" ");
+    serial_print(entity->domain_name);
+    serial_print("\n");
+}
+
+static void command_stats(void) {
+    uint32_t active = 0;
+    for (uint32_t i = 0; i < active_entity_count; i++) {
+        if (entity_pool[i].is_active) active++;
+    }
+    serial_print("[STATS] timestamp ");
+    serial_print_dec(holo_system.global_timestamp);
+    serial_print(" ticks ");
+    serial_print_dec(timer_ticks);
+    serial_print("\n  entities ");
+    serial_print_dec(active_entity_count);
+    serial_print(" (active ");
+    serial_print_dec(active);
+    serial_print(", dormant ");
+    serial_print_dec(active_entity_count - active);
+    serial_print(")\n  thoughts ");
+    serial_print_dec(collective.thought_count);
+    serial_print("/" );
+    serial_print_dec(MAX_THOUGHTS);
+    serial_print(" coherence x1000 ");
+    serial_print_dec((uint32_t)(collective.global_coherence * 1000));
+    serial_print("\n  memory entries ");
+    serial_print_dec(holo_system.memory_count);
+    serial_print("/");
+    serial_print_dec(MAX_MEMORY_ENTRIES);
+    serial_print(" heap used ");
+    serial_print_dec(heap_offset);
+    serial_print(" free ");
+    serial_print_dec(heap_get_free_space());
+    serial_print("\n  concepts ");
+    serial_print_dec(concepts.count);
+    serial_print(" registered, ");
+    serial_print_dec(concepts.materialized);
+    serial_print(" materialized, ");
+    serial_print_dec(concepts.association_count);
+    serial_print(" associations");
+    serial_print("\n  rx overruns ");
+    serial_print_dec(serial_rx.overruns);
+    serial_print("\n  top ");
+    serial_print_dec(params.top_k);
+    serial_print(" by fitness:\n");
+    uint8_t listed[MAX_ENTITIES] = {0};
+    for (uint32_t k = 0; k < params.top_k && k < active_entity_count; k++) {
+        uint32_t best = MAX_ENTITIES;
+        for (uint32_t i = 0; i < active_entity_count; i++) {
+            if (listed[i]) continue;
+            if (best == MAX_ENTITIES || entity_pool[i].fitness_score > entity_pool[best].fitness_score) best = i;
+        }
+        listed[best] = 1;
+        print_entity_line(&entity_pool[best]);
+    }
+}
+
+static void command_snapshot(void) {
+    serial_print("[SNAPSHOT] timestamp ");
+    serial_print_dec(holo_system.global_timestamp);
+    serial_print(" entities ");
+    serial_print_dec(active_entity_count);
+    serial_print("\n");
+    for (uint32_t i = 0; i < active_entity_count; i++) {
+        print_entity_line(&entity_pool[i]);
+    }
+    for (uint32_t i = 0; i < PARAM_COUNT; i++) {
+        print_param(i);
+    }
+    serial_print("[SNAPSHOT] end\n");
+}
+
+static const struct {
+    const char* name;
+    uint8_t mask;
+} log_sink_names[] = {
+    {"com1", LOG_SINK_COM1},
+    {"debugcon", LOG_SINK_DEBUGCON},
+    {"trace", LOG_SINK_TRACE},
+    {"vga", LOG_SINK_VGA},
+};
+#define LOG_SINK_NAME_COUNT (sizeof(log_sink_names) / sizeof(log_sink_names[0]))
+
+static void print_route(uint32_t subsystem) {
+    serial_print("  ");
+    serial_print(log_subsystem_names[subsystem]);
+    serial_print(" ->");
+    if (!log_config.routes[subsystem]) serial_print(" none");
+    for (uint32_t i = 0; i < LOG_SINK_NAME_COUNT; i++) {
+        if (log_config.routes[subsystem] & log_sink_names[i].mask) {
+            serial_write(' ');
+            serial_print(log_sink_names[i].name);
+        }
+    }
+    serial_print("\n");
+}
+
+// Parses "com1,debugcon", "none" or a numeric LOG_SINK_* mask.
+static int parse_sink_list(char* list, uint8_t* mask) {
+    uint32_t numeric;
+    if (parse_uint(list, &numeric)) {
+        *mask = (uint8_t)(numeric & 0x0F);
+        return 1;
+    }
+    *mask = 0;
+    if (str_equal(list, "none")) return 1;
+    while (*list) {
+        char* name = list;
+        while (*list && *list != ',') list++;
+        if (*list) *list++ = '\0';
+        uint32_t i;
+        for (i = 0; i < LOG_SINK_NAME_COUNT; i++) {
+            if (str_equal(log_sink_names[i].name, name)) break;
+        }
+        if (i == LOG_SINK_NAME_COUNT) return 0;
+        *mask |= log_sink_names[i].mask;
+    }
+    return 1;
+}
+
+static void command_route(char* cursor) {
+    char* name = next_token(&cursor);
+    char* sinks = next_token(&cursor);
+    uint8_t mask = 0;
+    // Parse once: parse_sink_list splits the list in place
+    if (sinks && !parse_sink_list(sinks, &mask)) {
+        serial_print("[CMD] sinks: none | com1,debugcon,trace,vga | mask\n");
+        return;
+    }
+    for (uint32_t i = 0; i < LOG_SUBSYSTEM_COUNT; i++) {
+        if (name && !str_equal(name, "all") && !str_equal(name, log_subsystem_names[i])) continue;
+        if (sinks) log_config.routes[i] = mask;
+        print_route(i);
+    }
+}
+
+static void command_trace(char* cursor) {
+    char* arg = next_token(&cursor);
+    if (arg && str_equal(arg, "clear")) {
+        trace_ring.head = 0;
+        trace_ring.count = 0;
+        return;
+    }
+    serial_print("[TRACE] ");
+    serial_print_dec(trace_ring.count);
+    serial_print(" bytes\n");
+    uint32_t start = (trace_ring.head + TRACE_RING_SIZE - trace_ring.count) % TRACE_RING_SIZE;
+    for (uint32_t i = 0; i < trace_ring.count; i++) {
+        serial_write(trace_ring.data[(start + i) % TRACE_RING_SIZE]);
+    }
+    serial_print("[TRACE] end\n");
+}
+
+static void command_patches(char* cursor) {
+    static const char* const state_names[] = {"free", "trial", "kept", "reverted", "superseded"};
+    char* arg = next_token(&cursor);
+    if (arg && str_equal(arg, "revert")) {
+        // Newest patch still in effect
+        for (uint32_t n = 1; n <= PATCH_ROLLBACK_ENTRIES; n++) {
+            struct PatchRollback* entry =
+                &patch_engine.rollback[(patch_engine.rollback_next + PATCH_ROLLBACK_ENTRIES - n) % PATCH_ROLLBACK_ENTRIES];
+            if (entry->state == PATCH_STATE_TRIAL || entry->state == PATCH_STATE_KEPT) {
+                if (patch_revert(entry) != 0) serial_print("[CMD] target rewritten since, patch not reverted\n");
+                break;
+            }
+        }
+    }
+    serial_print("[PATCH] committed ");
+    serial_print_dec(patch_engine.committed);
+    serial_print(" stale ");
+    serial_print_dec(patch_engine.stale);
+    serial_print(" dropped ");
+    serial_print_dec(patch_engine.dropped);
+    serial_print(" accepted ");
+    serial_print_dec(patch_engine.accepted);
+    serial_print(" reverted ");
+    serial_print_dec(patch_engine.reverted);
+    serial_print(" merged ");
+    serial_print_dec(patch_engine.merged);
+    serial_print(" queued ");
+    serial_print_dec(patch_engine.queued);
+    serial_print("\n");
+    for (uint32_t n = 1; n <= PATCH_LIST_MAX; n++) {
+        const struct PatchRollback* entry =
+            &patch_engine.rollback[(patch_engine.rollback_next + PATCH_ROLLBACK_ENTRIES - n) % PATCH_ROLLBACK_ENTRIES];
+        if (entry->state == PATCH_STATE_FREE) continue;
+        serial_print("  ");
+        serial_print_hex(entry->address);
+        serial_print_symbol(entry->address);
+        serial_print(" +");
+        serial_print_dec(entry->length);
+        serial_print(" by ");
+        serial_print_hex(entry->proposer);
+        serial_print(" intent ");
+        serial_print_hex(entry->intent);
+        serial_print(" cycle ");
+        serial_print_dec(entry->applied_cycle);
+        serial_print(" health ");
+        serial_print_dec(entry->start.health);
+        serial_print(" coherence ");
+        serial_print_dec(entry->start.coherence);
+        if (entry->state != PATCH_STATE_TRIAL && entry->arms[0].timed + entry->arms[1].timed) {
+            // Original vs patched: changes over each variant's cycles, mean cycle time
+            serial_print(" trial ");
+            serial_print_signed(entry->arms[0].health);
+            serial_print("/");
+            serial_print_signed(entry->arms[1].health);
+            serial_print(" ");
+            serial_print_signed(entry->arms[0].coherence);
+            serial_print("/");
+            serial_print_signed(entry->arms[1].coherence);
+            serial_print(" ");
+            serial_print_dec(patch_arm_cycle_tsc(entry, &entry->arms[0]));
+            serial_print("/");
+            serial_print_dec(patch_arm_cycle_tsc(entry, &entry->arms[1]));
+        }
+        serial_print(" ");
+        serial_print(state_names[entry->state]);
+        if (entry->failed & PATCH_FAIL_HEALTH) serial_print(" (health)");
+        if (entry->failed & PATCH_FAIL_COHERENCE) serial_print(" (coherence)");
+        if (entry->failed & PATCH_FAIL_SLOWER) serial_print(" (slower)");
+        serial_print("\n");
+    }
+}
+
+static void command_dispatch(char* cursor) {
+    char* slot_name = next_token(&cursor);
+    char* variant_name = next_token(&cursor);
+    if (slot_name && variant_name) {
+        for (uint32_t slot = 0; slot < DISPATCH_SLOT_COUNT; slot++) {
+            if (!str_equal(slot_name, dispatch_slots[slot].name)) continue;
+            for (uint32_t v = 0; v < dispatch_slots[slot].variant_count; v++) {
+                if (!str_equal(variant_name, dispatch_slots[slot].variants[v].name)) continue;
+                if (dispatch_propose_swap(slot, v, PATCH_PROPOSER_OPERATOR) != 0) {
+                    serial_print("[CMD] patch queue full, try again next cycle\n");
+                } else {
+                    serial_print("[CMD] swap staged for the next cycle boundary\n");
+                }
+                return;
+            }
+        }
+        serial_print("[CMD] usage: dispatch [slot variant]\n");
+    }
+    serial_print("[DISPATCH] version ");
+    serial_print_dec(dispatch.version);
+    serial_print("\n");
+    for (uint32_t slot = 0; slot < DISPATCH_SLOT_COUNT; slot++) {
+        uint32_t selected = dispatch_variant_index(slot);
+        serial_print("  ");
+        serial_print(dispatch_slots[slot].name);
+        serial_print(":");
+        for (uint32_t v = 0; v < dispatch_slots[slot].variant_count; v++) {
+            serial_print(v == selected ? " [" : " ");
+            serial_print(dispatch_slots[slot].variants[v].name);
+            if (v == selected) serial_print("]");
+        }
+        serial_print("\n");
+    }
+}
+
+static void serial_command_execute(char* line) {
+    char* cursor = line;
+    char* command = next_token(&cursor);
+    if (!command) return;
+    if (str_equal(command, "help")) {
+        serial_print("Commands: get [name] | set <name> <value> | stats | snapshot | scroll <rows>\n"
+                     "          route [subsystem|all] [sinks] | trace [clear] | telemetry\n"
+                     "          checkpoint | restore | export [sinks] | import\n"
+                     "          journal [flush|stop] | patches [revert] | dispatch [slot variant]\n"
+                     "          autotune | jit [flush] | profile [clear] | help\n");
+    } else if (str_equal(command, "get")) {
+        char* name = next_token(&cursor);
+        for (uint32_t i = 0; i < PARAM_COUNT; i++) {
+            if (!name || str_equal(param_table[i].name, name)) print_param(i);
+        }
+        if (name && !find_param(name)) serial_print("[CMD] unknown parameter\n");
+    } else if (str_equal(command, "set")) {
+        char* name = next_token(&cursor);
+        char* value_str = next_token(&cursor);
+        uint32_t* value = name ? find_param(name) : NULL;
+        uint32_t parsed;
+        if (!value) {
+            serial_print("[CMD] unknown parameter\n");
+        } else if (!value_str || !parse_uint(value_str, &parsed)) {
+            serial_print("[CMD] usage: set <name> <decimal|0xhex>\n");
+        } else {
+            *value = parsed;
+            serial_print("[CMD] ");
+            serial_print(name);
+            serial_print(" = ");
+            serial_print_dec(parsed);
+            serial_print("\n");
+        }
+    } else if (str_equal(command, "stats")) {
+        command_stats();
+    } else if (str_equal(command, "snapshot")) {
+        command_snapshot();
+    } else if (str_equal(command, "telemetry")) {
+        telemetry_emit();
+    } else if (str_equal(command, "route")) {
+        command_route(cursor);
+    } else if (str_equal(command, "trace")) {
+        command_trace(cursor);
+    } else if (str_equal(command, "checkpoint")) {
+        checkpoint_save();
+    } else if (str_equal(command, "restore")) {
+        // The replaced population's vectors stay allocated: kfree() is a no-op
+        if (checkpoint_load() != 0) serial_print("[CMD] restore failed, population unchanged\n");
+    } else if (str_equal(command, "export")) {
+        char* sinks = next_token(&cursor);
+        uint8_t mask = LOG_SINK_DEBUGCON;   // Binary, like telemetry: keep it off the shell
+        if (sinks && !parse_sink_list(sinks, &mask)) {
+            serial_print("[CMD] usage: export [com1,debugcon,...]\n");
+        } else {
+            population_export(mask);
+        }
+    } else if (str_equal(command, "import")) {
+        if (population_import() != 0) serial_print("[CMD] import failed, population unchanged\n");
+    } else if (str_equal(command, "journal")) {
+        command_journal(cursor);
+    } else if (str_equal(command, "patches")) {
+        command_patches(cursor);
+    } else if (str_equal(command, "dispatch")) {
+        command_dispatch(cursor);
+    } else if (str_equal(command, "autotune")) {
+        command_autotune();
+    } else if (str_equal(command, "jit")) {
+        command_jit(cursor);
+    } else if (str_equal(command, "profile")) {
+        command_profile(cursor);
+    } else if (str_equal(command, "scroll")) {
+        char* rows_str = next_token(&cursor);
+        uint32_t rows = 0;
+        if (rows_str && !parse_uint(rows_str, &rows)) rows = 0;
+        vga_console_scrollback((uint16_t)(rows > 0xFFFF ? 0xFFFF : rows));
+    } else {
+        serial_print("[CMD] unknown command, try 'help'\n");
+    }
+}
+
+static void serial_command_poll(void) {
+    uint8_t c;
+    while (serial_rx_pop(&c)) {
+        if (c == '\r' || c == '\n') {
+            serial_write('\n');
+            serial_command_line[serial_command_length] = '\0';
+            journal_command(serial_command_line);
+            serial_command_length = 0;
+        } else if (c == 0x08 || c == 0x7F) {
+            if (serial_command_length > 0) {
+                serial_command_length--;
+                serial_print("\b \b");
+            }
+        } else if (serial_command_length < SERIAL_COMMAND_MAX && c >= 0x20 && c < 0x7F) {
+            serial_command_line[serial_command_length++] = (char)c;
+            serial_write((char)c); // Echo
+        }
+    }
+}
+
+// Boot command line: whitespace-separated name=value pairs using the same
+// names as `set`. Other tokens (QEMU prepends the kernel path) are ignored.
+static void apply_boot_cmdline(const char* cmdline) {
+    char buffer[BOOT_CMDLINE_MAX];
+    uint32_t length = 0;
+    while (cmdline[length] && length < BOOT_CMDLINE_MAX - 1) {
+        buffer[length] = cmdline[length];
+        length++;
+    }
+    buffer[length] = '\0';
+    klog(LOG_SUB_BOOT, LOG_INFO, "[BOOT] Command line: ");
+    klog(LOG_SUB_BOOT, LOG_INFO, buffer);
+    klog(LOG_SUB_BOOT, LOG_INFO, "\n");
+    char* cursor = buffer;
+    char* token;
+    while ((token = next_token(&cursor)) != NULL) {
+        char* value_str = token;
+        while (*value_str && *value_str != '=') value_str++;
+        if (!*value_str) continue;
+        *value_str++ = '\0';
+        uint32_t* value = find_param(token);
+        uint32_t parsed;
+        if (!value || !parse_uint(value_str, &parsed)) {
+            klog(LOG_SUB_BOOT, LOG_WARN, "[BOOT] Ignoring boot option ");
+            klog(LOG_SUB_BOOT, LOG_WARN, token);
+            klog(LOG_SUB_BOOT, LOG_WARN, "\n");
+            continue;
+        }
+        *value = parsed;
+        klog(LOG_SUB_BOOT, LOG_INFO, "  ");
+        klog(LOG_SUB_BOOT, LOG_INFO, token);
+        klog(LOG_SUB_BOOT, LOG_INFO, " = ");
+        klog_dec(LOG_SUB_BOOT, LOG_INFO, parsed);
+        klog(LOG_SUB_BOOT, LOG_INFO, "\n");
+    }
 }
@@ -0,0 +1,24 @@
+// corpus.h - Concept corpus region of the data disk, shared by the kernel and tools/corpus_pack.c
+// Expects uint8_t/uint16_t/uint32_t to be defined by the includer.
+#ifndef HOLO_CORPUS_H
+#define HOLO_CORPUS_H
+
+#define CORPUS_MAGIC 0x50524348U        // "HCRP" in little-endian byte order
+#define CORPUS_VERSION 1
+#define CORPUS_LINE_MAX 256             // Longer lines are skipped
+
+// Little-endian, packed, alone in the first sector of the region. The text
+// payload follows from the next sector: one concept per line, its name then
+// the names of its associations, separated by spaces or tabs. Lines starting
+// with '#' are comments. header_crc32 is CRC-32/IEEE over every byte before it.
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;
+    uint32_t payload_length;      // Bytes of text
+    uint32_t line_count;          // Concept lines, for the loader's progress log
+    uint32_t payload_crc32;
+    uint32_t header_crc32;
+} __attribute__((packed)) CorpusHeader;
+
+#endif
@@ -0,0 +1,71 @@
+// population.h - Genome/population interchange format, shared by the kernel and tools/genome_tool.c
+// Expects uint8_t/uint16_t/uint32_t/int8_t to be defined by the includer.
+#ifndef HOLO_POPULATION_H
+#define HOLO_POPULATION_H
+
+#define POPULATION_MAGIC 0x50504B48U    // "HKPP" in little-endian byte order
+#define POPULATION_VERSION 1
+#define POPULATION_MAX_ENTITIES 32      // MAX_ENTITIES in the kernel
+#define POPULATION_MAX_GENES 16         // MAX_GENES_PER_ENTITY
+#define POPULATION_MAX_DIMENSIONS 2048  // MAX_DIMENSIONS
+#define POPULATION_DOMAINS 8            // MAX_ENTITY_DOMAINS
+#define POPULATION_QUANT_MAX 127
+
+// A population file is this header followed by payload_length bytes holding
+// entity_count entities. Each entity is a PopulationEntity, then its state
+// and task patterns, then gene_count × (PopulationGene, pattern).
+// Everything is little-endian and packed. header_crc32 is CRC-32/IEEE over
+// every header byte before it; payload_crc32 covers the payload.
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;
+    uint32_t entity_count;
+    uint32_t gene_count;          // All entities together
+    uint32_t payload_length;
+    uint32_t payload_crc32;
+    uint32_t header_crc32;
+} __attribute__((packed)) PopulationHeader;
+
+// A sparse pattern quantized to 8 bits: nonzero PopulationDim entries follow,
+// each dimension's value being value * scale / POPULATION_QUANT_MAX.
+// capacity 0 stands for a destroyed (NULL) vector.
+typedef struct {
+    uint16_t capacity;
+    uint16_t active_dims;
+    uint16_t nonzero;
+    uint16_t reserved;
+    float scale;                  // Largest magnitude in the vector
+} __attribute__((packed)) PopulationPattern;
+
+typedef struct {
+    uint16_t index;
+    int8_t value;
+} __attribute__((packed)) PopulationDim;
+
+typedef struct {
+    uint32_t id;                  // Informational: importers renumber by slot
+    uint32_t age;
+    uint32_t fitness_score;
+    uint32_t mutation_rate;
+    uint32_t spawn_count;
+    uint32_t path_id;
+    float confidence;
+    float resource_allocation;
+    float task_alignment;
+    float specialization_scores[POPULATION_DOMAINS];
+    char domain_name[32];
+    uint8_t is_active;
+    uint8_t is_mutant;
+    uint8_t gene_count;
+    uint8_t reserved;
+} __attribute__((packed)) PopulationEntity;
+
+typedef struct {
+    char name[16];
+    uint32_t fitness;
+    uint8_t mutable;
+    uint8_t reserved[3];
+} __attribute__((packed)) PopulationGene;
+
+#endif
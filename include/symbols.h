@@ -0,0 +1,29 @@
+// symbols.h - Embedded kernel symbol table, written by tools/symtab_gen.c
+// and linked into the image's .ksymtab section in a second link pass.
+// Expects uint8_t/uint16_t/uint32_t to be defined by the includer.
+#ifndef HOLO_SYMBOLS_H
+#define HOLO_SYMBOLS_H
+
+#define SYMBOLS_MAGIC 0x59534B48U       // "HKSY" in little-endian byte order
+#define SYMBOLS_VERSION 1
+#define SYMBOLS_NAME_MAX 64             // Longer names are truncated
+
+// The header is followed by count SymbolEntry records sorted by address,
+// then strings_length bytes of NUL-terminated names. Little-endian, packed;
+// the section is 4-byte aligned. Addresses are the kernel's, which both
+// builds keep below 4 GB.
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;
+    uint32_t count;
+    uint32_t strings_length;
+} __attribute__((packed)) SymbolTableHeader;
+
+typedef struct {
+    uint32_t address;
+    uint32_t size;                // From nm -S; 0 = unknown, runs to the next symbol
+    uint32_t name_offset;         // Into the strings
+} __attribute__((packed)) SymbolEntry;
+
+#endif
@@ -0,0 +1,45 @@
+// telemetry.h - Binary telemetry frame shared by the kernel and tools/telemetry_decode.c
+// Expects uint8_t/uint16_t/uint32_t to be defined by the includer.
+#ifndef HOLO_TELEMETRY_H
+#define HOLO_TELEMETRY_H
+
+#define TELEMETRY_MAGIC 0x4D544B48U     // "HKTM" in little-endian byte order
+#define TELEMETRY_VERSION 2
+#define TELEMETRY_KERNEL_SLOTS 9        // similarity, merge, hash x small, medium, large
+
+// Little-endian, packed. Emitted every `telemetry_interval` update cycles.
+// crc32 is CRC-32/IEEE over every byte before it. A decoder resynchronises
+// on the magic, so frames can share a stream with text logs.
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length;              // Whole frame, including crc32
+    uint32_t sequence;            // Frames emitted since boot
+    uint32_t timestamp;           // holo_system.global_timestamp
+    uint32_t ticks;               // PIT ticks (ms) since interrupts were enabled
+    uint32_t update_cycles;       // update_entities() calls since boot
+    uint16_t entities_active;
+    uint16_t entities_dormant;
+    uint32_t spawns_total;
+    uint32_t gc_marked;           // Entities currently marked_for_gc
+    uint32_t resonances_total;
+    int32_t coherence_milli;      // global_coherence x1000
+    uint16_t thoughts;
+    uint16_t thoughts_max;
+    uint16_t memory_entries;
+    uint16_t memory_max;
+    uint32_t heap_used;
+    uint32_t heap_peak;
+    uint32_t heap_size;
+    uint32_t cycle_p50;           // TSC cycles per update_entities(), last window
+    uint32_t cycle_p90;
+    uint32_t cycle_p99;
+    uint32_t dispatch_version;    // Dispatch-table swaps since boot
+    uint32_t autotune_runs;
+    uint8_t kernel_variant[TELEMETRY_KERNEL_SLOTS];   // Selected variant per kernel slot
+    uint8_t reserved[3];
+    uint32_t kernel_cycles[TELEMETRY_KERNEL_SLOTS];   // Its TSC cycles in the last autotuner run
+    uint32_t crc32;
+} __attribute__((packed)) TelemetryFrame;
+
+#endif
@@ -5,27 +5,164 @@
 [bits 32]
 
 global _start
+global isr_stub_table
 
 extern kmain
+extern isr_dispatch
+extern __bss_start                  ; linker.ld
+extern __bss_end
+
+MULTIBOOT_MAGIC equ 0x1BADB002
+MULTIBOOT_FLAGS equ 0x00000003      ; Page-align modules, provide memory info
 
 section .text
 _start:
+    ; boot.asm jumps here at 0x10000; a Multiboot loader enters through
+    ; the ELF entry point, which is the same address.
+    jmp short multiboot_entry
+
+align 4
+multiboot_header:
+    dd MULTIBOOT_MAGIC
+    dd MULTIBOOT_FLAGS
+    dd -(MULTIBOOT_MAGIC + MULTIBOOT_FLAGS)
+
+multiboot_entry:
+    ; EAX = 0x2BADB002 and EBX = info pointer when Multiboot-loaded; both
+    ; must survive until kmain. The loader's GDT is undefined, so load our
+    ; own with the selectors boot.asm uses (code 0x08, data 0x10).
+    cli
+    lgdt [kernel_gdt_descriptor]
+    jmp 0x08:.reload_segments
+.reload_segments:
+    mov cx, 0x10
+    mov ds, cx
+    mov es, cx
+    mov fs, cx
+    mov gs, cx
+    mov ss, cx
     mov esp, 0x90000
     cld
 
-    mov eax, 0xb8000
-    mov byte [eax], 'A'
-    mov byte [eax+1], 0x0F
-    mov byte [eax+2], 'S'
-    mov byte [eax+3], 0x0F
-    mov byte [eax+4], 'M'
-    mov byte [eax+5], 0x0F
-    mov byte [eax+6], '!'
-    mov byte [eax+7], 0x0F
+    ; boot.asm does not clear .bss; EAX/EBX are preserved for kmain
+    mov edx, eax
+    mov edi, __bss_start
+    mov ecx, __bss_end
+    sub ecx, edi
+    shr ecx, 2
+    xor eax, eax
+    rep stosd
+    mov eax, edx
+
+    mov edi, 0xb8000
+    mov byte [edi], 'A'
+    mov byte [edi+1], 0x0F
+    mov byte [edi+2], 'S'
+    mov byte [edi+3], 0x0F
+    mov byte [edi+4], 'M'
+    mov byte [edi+5], 0x0F
+    mov byte [edi+6], '!'
+    mov byte [edi+7], 0x0F
 
+    push ebx                        ; kmain(multiboot_magic, multiboot_info)
+    push eax
     call kmain
 
 hang:
     cli
     hlt
     jmp hang
+
+; --- Interrupt stubs ---
+; Every vector pushes a uniform frame (error code, vector, pusha) and
+; enters isr_dispatch(struct InterruptFrame*) in holographic_kernel.c.
+%macro isr_no_err_stub 1
+isr_stub_%+%1:
+    push dword 0
+    push dword %1
+    jmp isr_common
+%endmacro
+
+%macro isr_err_stub 1
+isr_stub_%+%1:
+    push dword %1
+    jmp isr_common
+%endmacro
+
+isr_common:
+    pusha
+    cld
+    push esp
+    call isr_dispatch
+    add esp, 4
+    popa
+    add esp, 8
+    iret
+
+isr_no_err_stub 0
+isr_no_err_stub 1
+isr_no_err_stub 2
+isr_no_err_stub 3
+isr_no_err_stub 4
+isr_no_err_stub 5
+isr_no_err_stub 6
+isr_no_err_stub 7
+isr_err_stub    8
+isr_no_err_stub 9
+isr_err_stub    10
+isr_err_stub    11
+isr_err_stub    12
+isr_err_stub    13
+isr_err_stub    14
+isr_no_err_stub 15
+isr_no_err_stub 16
+isr_err_stub    17
+isr_no_err_stub 18
+isr_no_err_stub 19
+isr_no_err_stub 20
+isr_err_stub    21
+isr_no_err_stub 22
+isr_no_err_stub 23
+isr_no_err_stub 24
+isr_no_err_stub 25
+isr_no_err_stub 26
+isr_no_err_stub 27
+isr_no_err_stub 28
+isr_err_stub    29
+isr_err_stub    30
+isr_no_err_stub 31
+; Remapped PIC IRQs 0-15
+isr_no_err_stub 32
+isr_no_err_stub 33
+isr_no_err_stub 34
+isr_no_err_stub 35
+isr_no_err_stub 36
+isr_no_err_stub 37
+isr_no_err_stub 38
+isr_no_err_stub 39
+isr_no_err_stub 40
+isr_no_err_stub 41
+isr_no_err_stub 42
+isr_no_err_stub 43
+isr_no_err_stub 44
+isr_no_err_stub 45
+isr_no_err_stub 46
+isr_no_err_stub 47
+
+section .data
+align 8
+kernel_gdt:
+    dq 0
+    dq 0x00CF9A000000FFFF           ; 0x08: flat 4 GB code
+    dq 0x00CF92000000FFFF           ; 0x10: flat 4 GB data
+kernel_gdt_end:
+kernel_gdt_descriptor:
+    dw kernel_gdt_end - kernel_gdt - 1
+    dd kernel_gdt
+
+isr_stub_table:
+%assign i 0
+%rep 48
+    dd isr_stub_%+i
+%assign i i+1
+%endrep
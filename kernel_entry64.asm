@@ -0,0 +1,284 @@
+; kernel_entry64.asm
+; Entry point of the x86-64 kernel. It is entered in 32-bit protected mode
+; (from boot.asm or a Multiboot loader), builds identity-mapped PAE page
+; tables, switches to long mode and calls kmain (in C).
+[bits 32]
+
+global _start
+global isr_stub_table
+
+extern kmain
+extern isr_dispatch
+extern _load_end                    ; linker64.ld
+extern __bss_start
+extern __bss_end
+
+MULTIBOOT_MAGIC equ 0x1BADB002
+; Page-align modules, provide memory info, use the address fields below:
+; loaders refuse ELF64 images unless they are told where to put the bytes
+MULTIBOOT_FLAGS equ 0x00010003
+
+PAGE_PRESENT_WRITE equ 0x03
+PAGE_LARGE         equ 0x80         ; 2 MB page in a page directory entry
+IDENTITY_MAP_GB    equ 4
+
+section .text
+_start:
+    ; boot.asm jumps here at 0x10000; a Multiboot loader enters through
+    ; the header's entry address, which is the same code.
+    jmp short multiboot_entry
+
+align 4
+multiboot_header:
+    dd MULTIBOOT_MAGIC
+    dd MULTIBOOT_FLAGS
+    dd -(MULTIBOOT_MAGIC + MULTIBOOT_FLAGS)
+    dd multiboot_header             ; header_addr
+    dd _start                       ; load_addr
+    dd _load_end                    ; load_end_addr
+    dd 0                            ; bss_end_addr: .bss is far above the image, cleared below
+    dd multiboot_entry              ; entry_addr
+
+multiboot_entry:
+    cli
+    mov [boot_magic], eax           ; kmain(multiboot_magic, multiboot_info)
+    mov [boot_info], ebx
+    lgdt [kernel_gdt_descriptor]    ; 32-bit base form, still valid in long mode
+    mov cx, 0x10
+    mov ds, cx
+    mov es, cx
+    mov fs, cx
+    mov gs, cx
+    mov ss, cx
+    mov esp, 0x90000
+    cld
+
+    ; Refuse to continue on CPUs without long mode
+    mov eax, 0x80000000
+    cpuid
+    cmp eax, 0x80000001
+    jb no_long_mode
+    mov eax, 0x80000001
+    cpuid
+    test edx, 1 << 29
+    jz no_long_mode
+
+    ; Nobody else clears .bss (page tables included), so do it before using it
+    mov edi, __bss_start
+    mov ecx, __bss_end
+    sub ecx, edi
+    shr ecx, 2
+    xor eax, eax
+    rep stosd
+
+    mov dword [pml4], pdpt + PAGE_PRESENT_WRITE
+    mov edi, pdpt
+    mov eax, page_directories + PAGE_PRESENT_WRITE
+    mov ecx, IDENTITY_MAP_GB
+.fill_pdpt:
+    mov [edi], eax
+    add eax, 4096
+    add edi, 8
+    loop .fill_pdpt
+
+    ; 512 x 2 MB pages per directory; the upper dwords stay zero below 4 GB
+    mov edi, page_directories
+    mov eax, PAGE_PRESENT_WRITE | PAGE_LARGE
+    mov ecx, IDENTITY_MAP_GB * 512
+.fill_pd:
+    mov [edi], eax
+    add eax, 0x200000
+    add edi, 8
+    loop .fill_pd
+
+    mov eax, cr4
+    or eax, (1 << 5) | (1 << 9) | (1 << 10) ; PAE, OSFXSR, OSXMMEXCPT
+    mov cr4, eax
+    mov eax, pml4
+    mov cr3, eax
+    mov ecx, 0xC0000080             ; EFER
+    rdmsr
+    or eax, 1 << 8                  ; LME
+    wrmsr
+    mov eax, cr0
+    and eax, ~(1 << 2)              ; EM off: SSE instead of x87 emulation
+    or eax, (1 << 31) | (1 << 1)    ; PG, MP
+    mov cr0, eax
+    jmp 0x08:long_mode_entry
+
+no_long_mode:
+    mov edi, 0xb8000
+    mov byte [edi], 'N'
+    mov byte [edi+1], 0x4F
+    mov byte [edi+2], 'O'
+    mov byte [edi+3], 0x4F
+    mov byte [edi+4], '6'
+    mov byte [edi+5], 0x4F
+    mov byte [edi+6], '4'
+    mov byte [edi+7], 0x4F
+    jmp hang
+
+[bits 64]
+long_mode_entry:
+    mov cx, 0x10
+    mov ds, cx
+    mov es, cx
+    mov fs, cx
+    mov gs, cx
+    mov ss, cx
+    mov rsp, 0x90000
+
+    mov edi, 0xb8000
+    mov byte [rdi], 'A'
+    mov byte [rdi+1], 0x0F
+    mov byte [rdi+2], 'S'
+    mov byte [rdi+3], 0x0F
+    mov byte [rdi+4], 'M'
+    mov byte [rdi+5], 0x0F
+    mov byte [rdi+6], '!'
+    mov byte [rdi+7], 0x0F
+
+    mov edi, [boot_magic]
+    mov esi, [boot_info]
+    call kmain
+
+hang:
+    cli
+    hlt
+    jmp hang
+
+; --- Interrupt stubs ---
+; Same frame as the 32-bit build (error code, vector, GPRs), widened to
+; 64 bits; see struct InterruptFrame in holographic_kernel.c.
+%macro isr_no_err_stub 1
+isr_stub_%+%1:
+    push qword 0
+    push qword %1
+    jmp isr_common
+%endmacro
+
+%macro isr_err_stub 1
+isr_stub_%+%1:
+    push qword %1
+    jmp isr_common
+%endmacro
+
+isr_common:
+    push rax
+    push rbx
+    push rcx
+    push rdx
+    push rsi
+    push rdi
+    push rbp
+    push r8
+    push r9
+    push r10
+    push r11
+    push r12
+    push r13
+    push r14
+    push r15
+    mov rbp, rsp
+    ; The C code may use XMM registers, so the interrupted state is saved
+    and rsp, -16
+    sub rsp, 512
+    fxsave [rsp]
+    mov rdi, rbp
+    cld
+    call isr_dispatch
+    fxrstor [rsp]
+    mov rsp, rbp
+    pop r15
+    pop r14
+    pop r13
+    pop r12
+    pop r11
+    pop r10
+    pop r9
+    pop r8
+    pop rbp
+    pop rdi
+    pop rsi
+    pop rdx
+    pop rcx
+    pop rbx
+    pop rax
+    add rsp, 16
+    iretq
+
+isr_no_err_stub 0
+isr_no_err_stub 1
+isr_no_err_stub 2
+isr_no_err_stub 3
+isr_no_err_stub 4
+isr_no_err_stub 5
+isr_no_err_stub 6
+isr_no_err_stub 7
+isr_err_stub    8
+isr_no_err_stub 9
+isr_err_stub    10
+isr_err_stub    11
+isr_err_stub    12
+isr_err_stub    13
+isr_err_stub    14
+isr_no_err_stub 15
+isr_no_err_stub 16
+isr_err_stub    17
+isr_no_err_stub 18
+isr_no_err_stub 19
+isr_no_err_stub 20
+isr_err_stub    21
+isr_no_err_stub 22
+isr_no_err_stub 23
+isr_no_err_stub 24
+isr_no_err_stub 25
+isr_no_err_stub 26
+isr_no_err_stub 27
+isr_no_err_stub 28
+isr_err_stub    29
+isr_err_stub    30
+isr_no_err_stub 31
+; Remapped PIC IRQs 0-15
+isr_no_err_stub 32
+isr_no_err_stub 33
+isr_no_err_stub 34
+isr_no_err_stub 35
+isr_no_err_stub 36
+isr_no_err_stub 37
+isr_no_err_stub 38
+isr_no_err_stub 39
+isr_no_err_stub 40
+isr_no_err_stub 41
+isr_no_err_stub 42
+isr_no_err_stub 43
+isr_no_err_stub 44
+isr_no_err_stub 45
+isr_no_err_stub 46
+isr_no_err_stub 47
+
+section .data
+align 8
+kernel_gdt:
+    dq 0
+    dq 0x00AF9A000000FFFF           ; 0x08: 64-bit code
+    dq 0x00CF92000000FFFF           ; 0x10: flat 4 GB data
+kernel_gdt_end:
+kernel_gdt_descriptor:
+    dw kernel_gdt_end - kernel_gdt - 1
+    dd kernel_gdt
+
+boot_magic: dd 0
+boot_info:  dd 0
+
+isr_stub_table:
+%assign i 0
+%rep 48
+    dq isr_stub_%+i
+%assign i i+1
+%endrep
+
+section .bss align=4096
+pml4:             resb 4096
+pdpt:             resb 4096
+page_directories: resb 4096 * IDENTITY_MAP_GB
@@ -0,0 +1,113 @@
+// lz4_stub.c - Uncompressed entry stub for the LZ4-packed kernel image
+// boot.asm loads this stub plus the packed kernel to LZ4_STUB_BASE. The stub
+// decompresses the kernel to its link address (0x10000), then jumps to
+// _start there exactly as boot.asm would jump to an uncompressed kernel.
+// The payload is `lz4 -l` output (legacy frame: magic, then blocks of at
+// most 8 MB each preceded by their compressed size).
+typedef unsigned char   uint8_t;
+typedef unsigned int    uint32_t;
+typedef unsigned long   uintptr_t;
+
+#define KERNEL_LINK_ADDR 0x10000
+#define LZ4_STUB_BASE 0x70000   // Must match lz4_stub.ld and the Makefile
+#define LZ4_LEGACY_MAGIC 0x184C2102
+#define LZ4_MIN_MATCH 4
+#define VIDEO_MEMORY 0xb8000
+
+// kernel.lz4, wrapped into an object by objcopy -I binary
+extern const uint8_t _binary_kernel_lz4_start[];
+extern const uint8_t _binary_kernel_lz4_end[];
+
+static uint32_t read_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// LZ4 lengths: a 4-bit field of 15 continues in following bytes until one is < 255
+static int lz4_read_length(const uint8_t** ip, const uint8_t* iend, uint32_t* length) {
+    uint8_t b;
+    do {
+        if (*ip >= iend) return -1;
+        b = *(*ip)++;
+        *length += b;
+    } while (b == 255);
+    return 0;
+}
+
+// Decompresses one raw LZ4 block. Returns the number of bytes written, or
+// -1 if the block is malformed or would overrun dst.
+static int lz4_decompress_block(const uint8_t* src, uint32_t src_len, uint8_t* dst, uint32_t dst_capacity) {
+    const uint8_t* ip = src;
+    const uint8_t* iend = src + src_len;
+    uint8_t* op = dst;
+    uint8_t* oend = dst + dst_capacity;
+
+    while (ip < iend) {
+        uint8_t token = *ip++;
+        uint32_t literals = token >> 4;
+        if (literals == 15 && lz4_read_length(&ip, iend, &literals) != 0) return -1;
+        if (literals > (uint32_t)(iend - ip) || literals > (uint32_t)(oend - op)) return -1;
+        for (uint32_t i = 0; i < literals; i++) {
+            *op++ = *ip++;
+        }
+        if (ip == iend) break; // The last sequence carries literals only
+
+        if (iend - ip < 2) return -1;
+        uint32_t offset = (uint32_t)ip[0] | ((uint32_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (uint32_t)(op - dst)) return -1;
+        uint32_t match_length = token & 0x0F;
+        if (match_length == 15 && lz4_read_length(&ip, iend, &match_length) != 0) return -1;
+        match_length += LZ4_MIN_MATCH;
+        if (match_length > (uint32_t)(oend - op)) return -1;
+        // Byte order matters: an offset shorter than the match repeats a pattern
+        const uint8_t* match = op - offset;
+        for (uint32_t i = 0; i < match_length; i++) {
+            *op++ = *match++;
+        }
+    }
+    return (int)(op - dst);
+}
+
+// Decompresses a legacy LZ4 frame. Returns the total size, or -1 on error.
+static int lz4_decompress_legacy(const uint8_t* src, uint32_t src_len, uint8_t* dst, uint32_t dst_capacity) {
+    if (src_len < 4 || read_le32(src) != LZ4_LEGACY_MAGIC) return -1;
+    uint32_t pos = 4;
+    uint32_t written = 0;
+    while (pos < src_len) {
+        if (src_len - pos < 4) return -1;
+        uint32_t block_size = read_le32(src + pos);
+        pos += 4;
+        if (block_size == LZ4_LEGACY_MAGIC) continue; // Concatenated frames
+        if (block_size > src_len - pos) return -1;
+        int n = lz4_decompress_block(src + pos, block_size, dst + written, dst_capacity - written);
+        if (n < 0) return -1;
+        written += (uint32_t)n;
+        pos += block_size;
+    }
+    return (int)written;
+}
+
+static void stub_fail(void) {
+    static const char message[] = "LZ4: bad kernel image";
+    volatile char* video = (volatile char*)VIDEO_MEMORY;
+    for (uint32_t i = 0; message[i]; i++) {
+        video[i * 2] = message[i];
+        video[i * 2 + 1] = 0x4F;
+    }
+    for (;;) {
+        __asm__ volatile ("cli; hlt");
+    }
+}
+
+// First bytes of the image (see lz4_stub.ld); entered from boot.asm in
+// 32-bit protected mode with flat segments and ESP = 0x90000.
+__attribute__((section(".text.entry"), noreturn))
+void lz4_stub_entry(void) {
+    uint32_t packed_size = (uint32_t)(_binary_kernel_lz4_end - _binary_kernel_lz4_start);
+    int size = lz4_decompress_legacy(_binary_kernel_lz4_start, packed_size,
+                                     (uint8_t*)KERNEL_LINK_ADDR, LZ4_STUB_BASE - KERNEL_LINK_ADDR);
+    if (size <= 0) stub_fail();
+    // EAX = 0 tells kernel_entry this is not a Multiboot boot
+    __asm__ volatile ("jmp *%0" : : "r"((uintptr_t)KERNEL_LINK_ADDR), "a"(0));
+    __builtin_unreachable();
+}
@@ -0,0 +1,103 @@
+// corpus_pack.c - Pack a text concept corpus into the data disk's corpus region
+// Usage: corpus_pack corpus.txt corpus.img
+// The output is the header sector followed by the text, padded to whole
+// sectors; `make corpus` writes it to the data disk at DATA_DISK_CORPUS_LBA.
+// Line format: see include/corpus.h.
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/corpus.h"
+
+#define SECTOR_SIZE 512
+#define CORPUS_REGION_SECTORS 26624     // DATA_DISK_CORPUS_SECTORS in the kernel
+
+static uint32_t crc32_update(uint32_t crc, const void* data, uint32_t length) {
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+    for (uint32_t i = 0; i < length; i++) {
+        crc ^= p[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+// Counts concept lines and reports lines the kernel would skip.
+static uint32_t count_lines(const char* text, size_t length, const char* path) {
+    uint32_t concepts = 0, line_number = 0;
+    size_t start = 0;
+    while (start < length) {
+        size_t end = start;
+        while (end < length && text[end] != '\n') end++;
+        line_number++;
+        size_t i = start;
+        while (i < end && (text[i] == ' ' || text[i] == '\t' || text[i] == '\r')) i++;
+        if (end - start + 1 > CORPUS_LINE_MAX) {
+            fprintf(stderr, "%s:%u: longer than %d bytes, the kernel will skip it\n",
+                    path, line_number, CORPUS_LINE_MAX - 1);
+        } else if (i < end && text[i] != '#') {
+            concepts++;
+        }
+        start = end + 1;
+    }
+    return concepts;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s corpus.txt corpus.img\n", argv[0]);
+        return 2;
+    }
+    FILE* in = fopen(argv[1], "rb");
+    if (!in) {
+        perror(argv[1]);
+        return 1;
+    }
+    size_t capacity = (size_t)(CORPUS_REGION_SECTORS - 1) * SECTOR_SIZE;
+    char* text = malloc(capacity + 1);
+    if (!text) {
+        perror("malloc");
+        return 1;
+    }
+    size_t length = fread(text, 1, capacity + 1, in);
+    fclose(in);
+    if (length > capacity) {
+        fprintf(stderr, "%s: corpus larger than the %zu-byte region\n", argv[1], capacity);
+        return 1;
+    }
+    if (memchr(text, '\0', length)) {
+        fprintf(stderr, "%s: corpus contains NUL bytes\n", argv[1]);
+        return 1;
+    }
+
+    uint8_t sector[SECTOR_SIZE] = {0};
+    CorpusHeader header;
+    header.magic = CORPUS_MAGIC;
+    header.version = CORPUS_VERSION;
+    header.header_size = sizeof(header);
+    header.payload_length = (uint32_t)length;
+    header.line_count = count_lines(text, length, argv[1]);
+    header.payload_crc32 = crc32_update(0, text, (uint32_t)length);
+    header.header_crc32 = crc32_update(0, &header, sizeof(header) - sizeof(header.header_crc32));
+    memcpy(sector, &header, sizeof(header));
+
+    FILE* out = fopen(argv[2], "wb");
+    if (!out) {
+        perror(argv[2]);
+        return 1;
+    }
+    size_t padding = (SECTOR_SIZE - length % SECTOR_SIZE) % SECTOR_SIZE;
+    static const uint8_t zeros[SECTOR_SIZE];
+    if (fwrite(sector, 1, sizeof(sector), out) != sizeof(sector) ||
+        fwrite(text, 1, length, out) != length ||
+        fwrite(zeros, 1, padding, out) != padding || fclose(out) != 0) {
+        perror(argv[2]);
+        return 1;
+    }
+    printf("%s: %u concept lines, %zu bytes, %zu sectors\n",
+           argv[2], header.line_count, length, 1 + (length + padding) / SECTOR_SIZE);
+    free(text);
+    return 0;
+}
@@ -0,0 +1,276 @@
+// genome_tool.c - Inspect, extract and merge population images (include/population.h)
+// Usage: genome_tool info FILE
+//        genome_tool extract CAPTURE OUT    (last valid image in a debugcon/serial capture)
+//        genome_tool merge [-n MAX] OUT IN...  (fittest MAX entities, default 32)
+// `make population POPULATION=OUT` then writes an image to the data disk,
+// where the kernel imports it at boot.
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/population.h"
+
+struct Image {
+    uint8_t* data;                // Header followed by the payload
+    size_t length;
+};
+
+// One entity record inside an image's payload
+struct EntitySpan {
+    const uint8_t* start;
+    size_t length;
+    uint32_t fitness;
+    uint32_t genes;
+};
+
+static uint32_t crc32_update(uint32_t crc, const void* data, uint32_t length) {
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+    for (uint32_t i = 0; i < length; i++) {
+        crc ^= p[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static int read_file(const char* path, struct Image* image) {
+    FILE* in = fopen(path, "rb");
+    if (!in) {
+        perror(path);
+        return -1;
+    }
+    size_t capacity = 1 << 16;
+    image->data = malloc(capacity);
+    image->length = 0;
+    size_t n;
+    while (image->data && (n = fread(image->data + image->length, 1, capacity - image->length, in)) > 0) {
+        image->length += n;
+        if (image->length == capacity) {
+            capacity *= 2;
+            image->data = realloc(image->data, capacity);
+        }
+    }
+    fclose(in);
+    if (!image->data) {
+        perror("malloc");
+        return -1;
+    }
+    return 0;
+}
+
+// Checks the header at p (at most `available` bytes) and its payload.
+static int image_valid(const uint8_t* p, size_t available) {
+    PopulationHeader header;
+    if (available < sizeof(header)) return 0;
+    memcpy(&header, p, sizeof(header));
+    return header.magic == POPULATION_MAGIC && header.version == POPULATION_VERSION &&
+           header.header_size == sizeof(header) &&
+           crc32_update(0, &header, sizeof(header) - sizeof(header.header_crc32)) == header.header_crc32 &&
+           header.payload_length <= available - sizeof(header) &&
+           crc32_update(0, p + sizeof(header), header.payload_length) == header.payload_crc32;
+}
+
+// Skips one pattern; returns its nonzero count, or -1 if it runs past end.
+static long skip_pattern(const uint8_t** p, const uint8_t* end) {
+    PopulationPattern pattern;
+    if ((size_t)(end - *p) < sizeof(pattern)) return -1;
+    memcpy(&pattern, *p, sizeof(pattern));
+    *p += sizeof(pattern);
+    size_t bytes = (size_t)pattern.nonzero * sizeof(PopulationDim);
+    if ((size_t)(end - *p) < bytes) return -1;
+    *p += bytes;
+    return pattern.nonzero;
+}
+
+// Splits a validated image into entity records. Returns the count, or -1.
+static long split_entities(const struct Image* image, struct EntitySpan* spans, size_t max_spans, int verbose) {
+    PopulationHeader header;
+    memcpy(&header, image->data, sizeof(header));
+    const uint8_t* p = image->data + sizeof(header);
+    const uint8_t* end = p + header.payload_length;
+    for (uint32_t i = 0; i < header.entity_count; i++) {
+        PopulationEntity entity;
+        const uint8_t* start = p;
+        if ((size_t)(end - p) < sizeof(entity)) return -1;
+        memcpy(&entity, p, sizeof(entity));
+        p += sizeof(entity);
+        entity.domain_name[sizeof(entity.domain_name) - 1] = '\0';
+        long state = skip_pattern(&p, end);
+        long task = skip_pattern(&p, end);
+        if (state < 0 || task < 0 || entity.gene_count > POPULATION_MAX_GENES) return -1;
+        if (verbose) {
+            printf("entity %u: id %u fitness %u age %u mutation %u.%u%% %s%s path 0x%X domain '%s' "
+                   "state %ld dims task %ld dims\n",
+                   i, entity.id, entity.fitness_score, entity.age,
+                   entity.mutation_rate / 10, entity.mutation_rate % 10,
+                   entity.is_active ? "active" : "dormant", entity.is_mutant ? " mutant" : "",
+                   entity.path_id, entity.domain_name, state, task);
+        }
+        for (uint32_t g = 0; g < entity.gene_count; g++) {
+            PopulationGene gene;
+            if ((size_t)(end - p) < sizeof(gene)) return -1;
+            memcpy(&gene, p, sizeof(gene));
+            p += sizeof(gene);
+            gene.name[sizeof(gene.name) - 1] = '\0';
+            long dims = skip_pattern(&p, end);
+            if (dims < 0) return -1;
+            if (verbose) {
+                printf("  gene %-16s fitness %u %s %ld dims\n",
+                       gene.name, gene.fitness, gene.mutable ? "mutable" : "fixed", dims);
+            }
+        }
+        if (spans && i < max_spans) {
+            spans[i].start = start;
+            spans[i].length = (size_t)(p - start);
+            spans[i].fitness = entity.fitness_score;
+            spans[i].genes = entity.gene_count;
+        }
+    }
+    return p == end ? (long)header.entity_count : -1;
+}
+
+static int command_info(const char* path) {
+    struct Image image;
+    if (read_file(path, &image) != 0) return 1;
+    if (!image_valid(image.data, image.length)) {
+        fprintf(stderr, "%s: not a valid population image\n", path);
+        return 1;
+    }
+    PopulationHeader header;
+    memcpy(&header, image.data, sizeof(header));
+    printf("%s: %u entities, %u genes, %u payload bytes\n",
+           path, header.entity_count, header.gene_count, header.payload_length);
+    if (split_entities(&image, NULL, 0, 1) < 0) {
+        fprintf(stderr, "%s: malformed entity records\n", path);
+        return 1;
+    }
+    free(image.data);
+    return 0;
+}
+
+static int write_image(const char* path, const uint8_t* image, size_t length) {
+    FILE* out = fopen(path, "wb");
+    if (!out || fwrite(image, 1, length, out) != length || fclose(out) != 0) {
+        perror(path);
+        return 1;
+    }
+    return 0;
+}
+
+static int command_extract(const char* capture_path, const char* out_path) {
+    struct Image capture;
+    if (read_file(capture_path, &capture) != 0) return 1;
+    const uint8_t* found = NULL;
+    size_t found_length = 0;
+    for (size_t i = 0; i + sizeof(PopulationHeader) <= capture.length; i++) {
+        uint32_t magic;
+        memcpy(&magic, capture.data + i, sizeof(magic));
+        if (magic != POPULATION_MAGIC || !image_valid(capture.data + i, capture.length - i)) continue;
+        PopulationHeader header;
+        memcpy(&header, capture.data + i, sizeof(header));
+        found = capture.data + i;
+        found_length = sizeof(header) + header.payload_length;
+        i += found_length - 1;
+    }
+    if (!found) {
+        fprintf(stderr, "%s: no valid population image found\n", capture_path);
+        return 1;
+    }
+    int status = write_image(out_path, found, found_length);
+    if (status == 0) printf("%s: %zu bytes\n", out_path, found_length);
+    free(capture.data);
+    return status;
+}
+
+static int compare_fitness(const void* a, const void* b) {
+    const struct EntitySpan* x = a;
+    const struct EntitySpan* y = b;
+    return (x->fitness < y->fitness) - (x->fitness > y->fitness);
+}
+
+static int command_merge(int max_entities, const char* out_path, int input_count, char** inputs) {
+    struct EntitySpan* spans = calloc((size_t)input_count * POPULATION_MAX_ENTITIES, sizeof(*spans));
+    struct Image* images = calloc((size_t)input_count, sizeof(*images));
+    size_t span_count = 0;
+    if (!spans || !images) {
+        perror("calloc");
+        return 1;
+    }
+    for (int i = 0; i < input_count; i++) {
+        if (read_file(inputs[i], &images[i]) != 0) return 1;
+        long n = image_valid(images[i].data, images[i].length)
+                     ? split_entities(&images[i], spans + span_count, POPULATION_MAX_ENTITIES, 0) : -1;
+        if (n < 0 || n > POPULATION_MAX_ENTITIES) {
+            fprintf(stderr, "%s: not a valid population image\n", inputs[i]);
+            return 1;
+        }
+        span_count += (size_t)n;
+    }
+    // Fittest first; records are copied whole, so patterns need no re-encoding
+    qsort(spans, span_count, sizeof(*spans), compare_fitness);
+    if (span_count > (size_t)max_entities) span_count = (size_t)max_entities;
+
+    PopulationHeader header;
+    memset(&header, 0, sizeof(header));
+    size_t payload_length = 0;
+    for (size_t i = 0; i < span_count; i++) {
+        payload_length += spans[i].length;
+        header.gene_count += spans[i].genes;
+    }
+    uint8_t* image = malloc(sizeof(header) + payload_length);
+    if (!image) {
+        perror("malloc");
+        return 1;
+    }
+    uint8_t* p = image + sizeof(header);
+    for (size_t i = 0; i < span_count; i++) {
+        memcpy(p, spans[i].start, spans[i].length);
+        p += spans[i].length;
+    }
+    header.magic = POPULATION_MAGIC;
+    header.version = POPULATION_VERSION;
+    header.header_size = sizeof(header);
+    header.entity_count = (uint32_t)span_count;
+    header.payload_length = (uint32_t)payload_length;
+    header.payload_crc32 = crc32_update(0, image + sizeof(header), (uint32_t)payload_length);
+    header.header_crc32 = crc32_update(0, &header, sizeof(header) - sizeof(header.header_crc32));
+    memcpy(image, &header, sizeof(header));
+    int status = write_image(out_path, image, sizeof(header) + payload_length);
+    if (status == 0) {
+        printf("%s: %u entities, %u genes from %d files\n", out_path, header.entity_count, header.gene_count, input_count);
+    }
+    free(image);
+    for (int i = 0; i < input_count; i++) free(images[i].data);
+    free(images);
+    free(spans);
+    return status;
+}
+
+static int usage(const char* argv0) {
+    fprintf(stderr, "usage: %s info FILE\n"
+                    "       %s extract CAPTURE OUT\n"
+                    "       %s merge [-n MAX] OUT IN...\n", argv0, argv0, argv0);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && strcmp(argv[1], "info") == 0) return command_info(argv[2]);
+    if (argc == 4 && strcmp(argv[1], "extract") == 0) return command_extract(argv[2], argv[3]);
+    if (argc >= 4 && strcmp(argv[1], "merge") == 0) {
+        int first = 2;
+        int max_entities = POPULATION_MAX_ENTITIES;
+        if (strcmp(argv[2], "-n") == 0) {
+            max_entities = atoi(argv[3]);
+            first = 4;
+            if (max_entities < 1 || max_entities > POPULATION_MAX_ENTITIES) {
+                fprintf(stderr, "MAX must be 1-%d\n", POPULATION_MAX_ENTITIES);
+                return 2;
+            }
+        }
+        if (argc - first < 2) return usage(argv[0]);
+        return command_merge(max_entities, argv[first], argc - first - 1, argv + first + 1);
+    }
+    return usage(argv[0]);
+}
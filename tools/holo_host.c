@@ -0,0 +1,133 @@
+// holo_host.c - Run the kernel as a Linux process for benchmarking and profiling
+// Usage: holo_host [-n CYCLES] [-d DEBUGCON_FILE] [name=value ...]
+// Links against libholokernel.a (holographic_kernel.c built with -DHOLO_HOSTED)
+// and enters kmain with a Multiboot block whose command line is the name=value
+// pairs, as `make run-kernel` does. COM1 output goes to stdout and port 0xE9
+// to DEBUGCON_FILE. kmain returns after CYCLES update cycles (default 1000);
+// the time per cycle then goes to stderr. Run it under perf, gdb or valgrind.
+// There is no data disk, no interrupts and no serial input.
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MULTIBOOT_BOOTLOADER_MAGIC 0x2BADB002U
+#define MULTIBOOT_INFO_MEMORY 0x001
+#define MULTIBOOT_INFO_CMDLINE 0x004
+#define HOST_CMDLINE_MAX 1024
+
+// Same layout as struct MultibootInfo in holographic_kernel.c
+struct MultibootInfo {
+    uint32_t flags;
+    uint32_t mem_lower;
+    uint32_t mem_upper;
+    uint32_t boot_device;
+    uint32_t cmdline;
+    uint32_t mods_count;
+    uint32_t mods_addr;
+    uint32_t syms[4];
+    uint32_t mmap_length;
+    uint32_t mmap_addr;
+} __attribute__((packed));
+
+void kmain(uint32_t multiboot_magic, uint32_t multiboot_info_addr);
+
+// Static, so -no-pie keeps them below 4 GB where the kernel's 32-bit addresses reach
+static struct MultibootInfo boot_info;
+static char boot_cmdline[HOST_CMDLINE_MAX];
+static uint32_t cycle_limit = 1000;
+static FILE* debugcon;
+static int uart_dlab;                 // Line control bit 7: 0x3F8 is the divisor latch
+static struct timespec loop_start;
+static int loop_started;
+
+void hosted_port_write(uint16_t port, uint8_t value) {
+    if (port == 0x3F8 + 3) {
+        uart_dlab = (value & 0x80) != 0;
+    } else if (port == 0x3F8 && !uart_dlab) {
+        putchar(value);
+    } else if (port == 0xE9 && debugcon) {
+        fputc(value, debugcon);
+    }
+}
+
+// Called after every update cycle; returning 0 makes kmain return
+int hosted_continue(uint32_t update_cycles) {
+    if (!loop_started) {
+        // Boot (calibration, seeding, the first cycle) is not part of the measurement
+        clock_gettime(CLOCK_MONOTONIC, &loop_start);
+        loop_started = 1;
+    }
+    return update_cycles < cycle_limit;
+}
+
+// The rule JIT writes x86 code into a static arena
+void hosted_map_executable(void* start, uint32_t length) {
+    uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t first = (uintptr_t)start & ~(page - 1);
+    uintptr_t end = ((uintptr_t)start + length + page - 1) & ~(page - 1);
+    if (mprotect((void*)first, end - first, PROT_READ | PROT_WRITE | PROT_EXEC) != 0) {
+        perror("mprotect");
+        exit(1);
+    }
+}
+
+static int usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [-n CYCLES] [-d DEBUGCON_FILE] [name=value ...]\n", argv0);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            long cycles = atol(argv[++i]);
+            if (cycles < 1) return usage(argv[0]);
+            cycle_limit = (uint32_t)cycles;
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            debugcon = fopen(argv[++i], "w");
+            if (!debugcon) {
+                perror(argv[i]);
+                return 1;
+            }
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    size_t used = 0;
+    for (; i < argc; i++) {
+        size_t length = strlen(argv[i]);
+        if (used + length + 2 > sizeof(boot_cmdline)) {
+            fprintf(stderr, "command line longer than %d bytes\n", HOST_CMDLINE_MAX - 1);
+            return 2;
+        }
+        if (used) boot_cmdline[used++] = ' ';
+        memcpy(boot_cmdline + used, argv[i], length + 1);
+        used += length;
+    }
+    if ((uintptr_t)&boot_info > 0xFFFFFFFFU) {
+        fprintf(stderr, "holo_host must be linked with -no-pie\n");
+        return 1;
+    }
+    boot_info.flags = MULTIBOOT_INFO_MEMORY | MULTIBOOT_INFO_CMDLINE;
+    boot_info.mem_lower = 640;
+    boot_info.mem_upper = 127 * 1024;
+    boot_info.cmdline = (uint32_t)(uintptr_t)boot_cmdline;
+
+    kmain(MULTIBOOT_BOOTLOADER_MAGIC, (uint32_t)(uintptr_t)&boot_info);
+
+    struct timespec loop_end;
+    clock_gettime(CLOCK_MONOTONIC, &loop_end);
+    fflush(stdout);
+    if (debugcon) fclose(debugcon);
+    double elapsed = (double)(loop_end.tv_sec - loop_start.tv_sec) +
+                     (double)(loop_end.tv_nsec - loop_start.tv_nsec) / 1e9;
+    uint32_t measured = cycle_limit > 1 ? cycle_limit - 1 : 1;
+    fprintf(stderr, "holo_host: %u update cycles, %.3f s after the first, %.1f us/cycle\n",
+            cycle_limit, elapsed, elapsed * 1e6 / measured);
+    return 0;
+}
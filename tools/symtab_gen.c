@@ -0,0 +1,108 @@
+// symtab_gen.c - Build the kernel's embedded symbol table (include/symbols.h)
+// Usage: nm -n -S kernel.stage1.elf | symtab_gen kernel.syms.bin
+// Keeps code, read-only data, data and bss symbols. The Makefile wraps the
+// output in an object whose .ksymtab section the second link pass places
+// after .data, so adding it moves no other symbol.
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/symbols.h"
+
+struct Symbol {
+    uint32_t address;
+    uint32_t size;
+    char name[SYMBOLS_NAME_MAX];
+};
+
+static int compare_address(const void* a, const void* b) {
+    const struct Symbol* x = a;
+    const struct Symbol* y = b;
+    if (x->address != y->address) return (x->address > y->address) - (x->address < y->address);
+    // Prefer the sized symbol at a shared address, then the global one
+    if ((x->size != 0) != (y->size != 0)) return x->size ? -1 : 1;
+    return strcmp(x->name, y->name);
+}
+
+// Parses "ADDR [SIZE] TYPE NAME". Returns 1 for a symbol worth keeping.
+static int parse_line(char* line, struct Symbol* symbol) {
+    char* fields[4];
+    int count = 0;
+    for (char* token = strtok(line, " \t\r\n"); token && count < 4; token = strtok(NULL, " \t\r\n")) {
+        fields[count++] = token;
+    }
+    if (count < 3) return 0;
+    int has_size = count == 4;
+    const char* type = fields[has_size ? 2 : 1];
+    const char* name = fields[has_size ? 3 : 2];
+    if (strlen(type) != 1 || !strchr("TtRrDdBb", type[0])) return 0;
+    // The table's own bounds differ between the two passes
+    if (strncmp(name, "__ksymtab", 9) == 0 || strncmp(name, "_binary_", 8) == 0) return 0;
+    unsigned long long address = strtoull(fields[0], NULL, 16);
+    if (address > 0xFFFFFFFFULL) return 0;
+    symbol->address = (uint32_t)address;
+    symbol->size = has_size ? (uint32_t)strtoul(fields[1], NULL, 16) : 0;
+    snprintf(symbol->name, sizeof(symbol->name), "%s", name);
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: nm -n -S kernel.elf | %s out.bin\n", argv[0]);
+        return 2;
+    }
+    size_t capacity = 1024, count = 0;
+    struct Symbol* symbols = malloc(capacity * sizeof(*symbols));
+    char line[512];
+    while (symbols && fgets(line, sizeof(line), stdin)) {
+        if (!parse_line(line, &symbols[count])) continue;
+        if (++count == capacity) {
+            capacity *= 2;
+            symbols = realloc(symbols, capacity * sizeof(*symbols));
+        }
+    }
+    if (!symbols) {
+        perror("malloc");
+        return 1;
+    }
+    qsort(symbols, count, sizeof(*symbols), compare_address);
+    // One name per address: lookups return the last entry at or below an address
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (kept && symbols[kept - 1].address == symbols[i].address) continue;
+        symbols[kept++] = symbols[i];
+    }
+    count = kept;
+
+    SymbolTableHeader header;
+    header.magic = SYMBOLS_MAGIC;
+    header.version = SYMBOLS_VERSION;
+    header.header_size = sizeof(header);
+    header.count = (uint32_t)count;
+    header.strings_length = 0;
+    for (size_t i = 0; i < count; i++) header.strings_length += (uint32_t)strlen(symbols[i].name) + 1;
+
+    FILE* out = fopen(argv[1], "wb");
+    if (!out) {
+        perror(argv[1]);
+        return 1;
+    }
+    int failed = fwrite(&header, sizeof(header), 1, out) != 1;
+    uint32_t name_offset = 0;
+    for (size_t i = 0; i < count && !failed; i++) {
+        SymbolEntry entry = {symbols[i].address, symbols[i].size, name_offset};
+        failed = fwrite(&entry, sizeof(entry), 1, out) != 1;
+        name_offset += (uint32_t)strlen(symbols[i].name) + 1;
+    }
+    for (size_t i = 0; i < count && !failed; i++) {
+        failed = fputs(symbols[i].name, out) == EOF || fputc('\0', out) == EOF;
+    }
+    if (failed || fclose(out) != 0) {
+        perror(argv[1]);
+        return 1;
+    }
+    printf("%s: %u symbols, %u bytes\n", argv[1], header.count,
+           (unsigned)(sizeof(header) + count * sizeof(SymbolEntry) + header.strings_length));
+    free(symbols);
+    return 0;
+}
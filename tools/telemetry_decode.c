@@ -0,0 +1,89 @@
+// telemetry_decode.c - Turn a kernel telemetry stream into CSV time series
+// Usage: telemetry_decode [capture-file]   (reads stdin when no file is given)
+// The capture can be the debugcon log, a raw serial log, or anything else the
+// telemetry route was sent to; text between frames is skipped.
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "../include/telemetry.h"
+
+static uint32_t crc32_update(uint32_t crc, const void* data, uint32_t length) {
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+    for (uint32_t i = 0; i < length; i++) {
+        crc ^= p[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+// Kernel slot names in TelemetryFrame order; variants are numbered as in `dispatch`
+static const char* const kernel_slots[TELEMETRY_KERNEL_SLOTS] = {
+    "similarity_small", "similarity_medium", "similarity_large",
+    "merge_small", "merge_medium", "merge_large",
+    "hash_small", "hash_medium", "hash_large"
+};
+
+static void print_frame(const TelemetryFrame* f) {
+    printf("%u,%u,%u,%u,%u,%u,%u,%u,%u,%.3f,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u",
+           f->sequence, f->timestamp, f->ticks, f->update_cycles,
+           f->entities_active, f->entities_dormant, f->spawns_total, f->gc_marked,
+           f->resonances_total, f->coherence_milli / 1000.0,
+           f->thoughts, f->thoughts_max, f->memory_entries, f->memory_max,
+           f->heap_used, f->heap_peak, f->heap_size,
+           f->cycle_p50, f->cycle_p90, f->cycle_p99, f->dispatch_version, f->autotune_runs);
+    for (int k = 0; k < TELEMETRY_KERNEL_SLOTS; k++) {
+        printf(",%u,%u", f->kernel_variant[k], f->kernel_cycles[k]);
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv) {
+    FILE* in = stdin;
+    if (argc > 1 && strcmp(argv[1], "-") != 0) {
+        in = fopen(argv[1], "rb");
+        if (!in) {
+            perror(argv[1]);
+            return 1;
+        }
+    }
+    printf("sequence,timestamp,ticks,update_cycles,active,dormant,spawns,gc_marked,"
+           "resonances,coherence,thoughts,thoughts_max,memory,memory_max,"
+           "heap_used,heap_peak,heap_size,cycle_p50,cycle_p90,cycle_p99,dispatch_version,autotune_runs");
+    for (int k = 0; k < TELEMETRY_KERNEL_SLOTS; k++) {
+        printf(",%s_variant,%s_cycles", kernel_slots[k], kernel_slots[k]);
+    }
+    printf("\n");
+    uint8_t window[sizeof(TelemetryFrame)];
+    size_t filled = 0;
+    unsigned long good = 0, bad = 0;
+    int c;
+    while ((c = fgetc(in)) != EOF) {
+        window[filled++] = (uint8_t)c;
+        // Slide until the window starts with the magic
+        while (filled >= 4) {
+            uint32_t magic;
+            memcpy(&magic, window, 4);
+            if (magic == TELEMETRY_MAGIC) break;
+            memmove(window, window + 1, --filled);
+        }
+        if (filled < sizeof(TelemetryFrame)) continue;
+        TelemetryFrame frame;
+        memcpy(&frame, window, sizeof(frame));
+        if (frame.version == TELEMETRY_VERSION && frame.length == sizeof(frame) &&
+            crc32_update(0, &frame, sizeof(frame) - sizeof(frame.crc32)) == frame.crc32) {
+            print_frame(&frame);
+            good++;
+            filled = 0;
+        } else {
+            // False magic or a damaged frame: resynchronise one byte later
+            bad++;
+            memmove(window, window + 1, --filled);
+        }
+    }
+    if (in != stdin) fclose(in);
+    fprintf(stderr, "%lu frames decoded, %lu rejected\n", good, bad);
+    return 0;
+}